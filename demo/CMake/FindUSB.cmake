@@ -1,4 +1,4 @@
-# - Try to find USB
+# - Try to find USB (libusb-1.0)
 # Once done this will define
 #
 #  USB_FOUND - system has USB
@@ -20,7 +20,9 @@ if (USB_LIBRARIES AND USB_INCLUDE_DIRS)
 else (USB_LIBRARIES AND USB_INCLUDE_DIRS)
   find_path(USB_INCLUDE_DIR
     NAMES
-      usb.h
+      libusb.h
+    PATH_SUFFIXES
+      libusb-1.0
     PATHS
       /usr/include
       /usr/local/include
@@ -30,7 +32,7 @@ else (USB_LIBRARIES AND USB_INCLUDE_DIRS)
 
   find_library(USB_LIBRARY
     NAMES
-      usb
+      usb-1.0
     PATHS
       /usr/lib
       /usr/local/lib
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////
+// Throughput of the CrayOn software model
+// ---------------------------------------------------------
+// Runs the c9-p2-c9-p2-c9-p2-c9 network of the demo on a
+// 320 x 240 tile, with the scalar and the AVX2 convolutions,
+// and checks that both produce the same results.
+// usage : engine_bench [program.coe kernels.coe [n_tiles]]
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../include/Engine.h"
+#include "../include/Program.h"
+#include "../include/Model.h"
+#include "../include/Timer.h"
+
+static const int IO_SIZE = 76800;
+
+// Same load requests as 'Interface::load()'
+void upload(Engine& engine, Model& model) {
+	engine.request(2, (unsigned char*) model.program());
+
+	int n_chunks = model.kernelsSize() / Model::KERNELS_CHUNK;
+	for (int chunk = 0; chunk < n_chunks; chunk++)
+		engine.request(1 + (chunk << 2), (unsigned char*) model.kernels() + chunk * Model::KERNELS_CHUNK);
+}
+
+double run(Engine& engine, const std::vector <unsigned char>& tile, int n_tiles, 
+           std::vector <unsigned char>& result) {
+	Timer timer;
+	timer.reset();
+	for (int k = 0; k < n_tiles; k++) {
+		result = tile;
+		engine.request(0, &result[0]);
+	}
+	return timer.getMillisec() / n_tiles;
+}
+
+int main(int argc, char* argv[]) {
+	const char* program_path = (argc > 2) ? argv[1] : "../coe/p_xz11.coe";
+	const char* kernels_path = (argc > 2) ? argv[2] : "../coe/k_xz11.coe";
+	int n_tiles = (argc > 3) ? atoi(argv[3]) : 10;
+
+	Model model;
+	model.setProgram(Model::parseCoe(program_path));
+	model.setKernels(Model::parseCoe(kernels_path));
+
+	// complemented pixels of a smooth pattern, with some edges
+	std::vector <unsigned char> tile(IO_SIZE);
+	for (int k = 0; k < IO_SIZE; k++) {
+		int x = k % 320, y = k / 320;
+		tile[k] = ((x * x / 7 + y * 3) ^ ((x / 40 + y / 30) % 2 ? 0x40 : 0)) + 128;
+	}
+
+	Engine scalar, vector;
+	scalar.setVectorized(false);
+	upload(scalar, model);
+	upload(vector, model);
+
+	std::vector <unsigned char> scalar_result, vector_result;
+	double scalar_time = run(scalar, tile, n_tiles, scalar_result);
+	double vector_time = run(vector, tile, n_tiles, vector_result);
+
+	double device_time = Program(model.programWords()).time();
+
+	std::cout << "# Device time      : " << device_time << " ms / tile (predicted)\n";
+	std::cout << "# Scalar engine    : " << scalar_time << " ms / tile\n";
+	if (vector.vectorized())
+		std::cout << "# AVX2 engine      : " << vector_time << " ms / tile ("
+		          << scalar_time / vector_time << "x, " 
+		          << 100 * device_time / vector_time << " % of the device)\n";
+	else
+		std::cout << "# AVX2 engine      : not supported by this CPU\n";
+
+	if (scalar_result != vector_result) {
+		std::cout << "# [bench_error] The AVX2 and scalar results differ !\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////
+// Micro-benchmarks of the host kernels
+// ---------------------------------------------------------
+// Times the frame, canva, tiling and detection kernels on
+// the sizes of the demo: a KITTI frame of the bundled data,
+// scaled by 0.64 and cropped to 720 x 240, and the heat maps
+// the software model computes from it.
+// Each kernel runs in batches of about 20 ms, the best batch
+// giving its time. The results are written one JSON object
+// per line, and can be saved as a baseline: against it, a 
+// kernel slower by more than the tolerance is a regression
+// (exit code 1). 'host_baseline.ndjson' is the reference of
+// the 'host_bench_check' target, to be saved again on the
+// machine the checks run on.
+// usage : host_bench [--baseline=<file>] [--save=<file>]
+//                    [--tolerance=<%>] [--frame=<png>]
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../include/Frame.h"
+#include "../include/Canva.h"
+#include "../include/Loader.h"
+#include "../include/Interface.h"
+#include "../include/Detector.h"
+#include "../include/PeakFinder.h"
+#include "../include/Trace.h"
+
+static const int BATCHES	= 7;
+static const double BATCH	= 20e6;	// ns
+
+struct Result {
+	std::string name;
+	double time;	// ns per call
+	long calls;		// per batch
+};
+
+// Best time of a call, over batches of about BATCH ns
+Result measure(const std::string& name, const std::function <void ()>& kernel) {
+	kernel();	// warm up (allocations, caches)
+
+	uint64_t begin = Trace::now();
+	long calls = 0;
+	do {
+		kernel();
+		calls++;
+	} while (Trace::now() - begin < BATCH / 4);
+	calls = std::max(1L, (long) (calls * BATCH / (Trace::now() - begin)));
+
+	Result result = {name, 0, calls};
+	for (int batch = 0; batch < BATCHES; batch++) {
+		begin = Trace::now();
+		for (long k = 0; k < calls; k++)
+			kernel();
+		double time = (double) (Trace::now() - begin) / calls;
+		if (batch == 0 || time < result.time)
+			result.time = time;
+	}
+	return result;
+}
+
+// The lines written by a former run
+std::map <std::string, double> readBaseline(const std::string& filename) {
+	std::map <std::string, double> baseline;
+	std::ifstream file(filename.c_str());
+	std::string line;
+
+	while (std::getline(file, line)) {
+		char name[128];
+		double time;
+		if (sscanf(line.c_str(), "{\"name\":\"%127[^\"]\",\"ns\":%lf", name, &time) == 2)
+			baseline[name] = time;
+	}
+	return baseline;
+}
+
+int main(int argc, char* argv[]) {
+	const int N_OUT		= 3;
+	const char * ARCH	= "c9-p2-c9-p2-c9-p2-c9";
+
+	const int H_SIZE	= 720;
+	const int V_SIZE	= 240;
+
+	std::string frame_path = "../data/kitti-51/0000000010.png";
+	std::string baseline_path, save_path;
+	double tolerance = 10;
+
+	for (int i = 1; i < argc; i++) {
+		std::string argument(argv[i]);
+		if (argument.compare(0, 11, "--baseline=") == 0)
+			baseline_path = argument.substr(11);
+		else if (argument.compare(0, 7, "--save=") == 0)
+			save_path = argument.substr(7);
+		else if (argument.compare(0, 12, "--tolerance=") == 0)
+			tolerance = atof(argument.substr(12).c_str());
+		else if (argument.compare(0, 8, "--frame=") == 0)
+			frame_path = argument.substr(8);
+		else {
+			std::cout << "# [bench_error] Unknown argument : " << argument << "\n";
+			return 1;
+		}
+	}
+
+	// Data /////////////////////////////////////////////////////////////////////
+	Frame source;
+	if (!Loader::decode(frame_path, source)) {
+		std::cout << "# [bench_error] Cannot decode '" << frame_path << "' !\n";
+		return 1;
+	}
+
+	Canva canva;
+	Frame input;
+	canva.resizeCrop(source, input, 0.64, H_SIZE, V_SIZE);
+
+	// the heat maps of the frame, from the software model
+	Interface CrayOn(ARCH, "cpu:1");
+	CrayOn.setLabelNb(N_OUT);
+	CrayOn.load("../coe/p_xz11.coe", 'p');
+	CrayOn.load("../coe/k_xz11.coe", 'k');
+	CrayOn.push(input);
+	CrayOn.process();
+
+	std::vector <Frame> heat_maps;
+	for (int i = 1; i < N_OUT; i++)
+		heat_maps.push_back(CrayOn.pull(i));
+
+	// a rectified and washed map, as searched for peaks
+	Frame peaks_map = heat_maps[0];
+	for (int k = 0; k < peaks_map.width() * peaks_map.height(); k++)
+		peaks_map.data()[k] = std::min(255, std::max(0, (peaks_map.data()[k] - 127) * 4));
+	canva.blur(peaks_map, 4);
+
+	std::vector <char> slots(CrayOn.tileCount() * 76800);
+	for (int tile = 0; tile < CrayOn.tileCount(); tile++)
+		CrayOn.gatherTile(tile, &slots[tile * 76800]);
+
+	// Kernels //////////////////////////////////////////////////////////////////
+	Frame work, output;
+	Frame negative = input;	// complemented over and over, 'input' is left as is
+	Detector detector(H_SIZE, V_SIZE);
+	detector.setStride(8);
+	PeakFinder peak_finder(3, 0.75 * 255);
+	std::vector <PeakFinder::Cluster> clusters;
+
+	std::vector <Result> results;
+	results.push_back(measure("frame_crop", [&] () { 
+		work = input; work.crop(40, 20, 640, 200); }));
+	results.push_back(measure("frame_complement", [&] () { 
+		negative.complement(); }));
+	results.push_back(measure("canva_resize", [&] () { 
+		canva.resize(source, output, 0.64); }));
+	results.push_back(measure("canva_resize_crop", [&] () { 
+		canva.resizeCrop(source, output, 0.64, H_SIZE, V_SIZE); }));
+	results.push_back(measure("canva_blur", [&] () { 
+		canva.blur(input, output, 4); }));
+	results.push_back(measure("canva_normalize", [&] () { 
+		work = input; canva.normalize(work, 4); }));
+	results.push_back(measure("interface_gather", [&] () { 
+		for (int tile = 0; tile < CrayOn.tileCount(); tile++)
+			CrayOn.gatherTile(tile, &slots[tile * 76800]); }));
+	results.push_back(measure("interface_stitch", [&] () { 
+		for (int tile = 0; tile < CrayOn.tileCount(); tile++)
+			CrayOn.receiveTile(tile, &slots[tile * 76800]); }));
+	results.push_back(measure("detector_process", [&] () { 
+		for (int i = 0; i < heat_maps.size(); i++)
+			detector.pushHeatMap(heat_maps[i]);
+		detector.process(); }));
+	results.push_back(measure("peak_finder", [&] () { 
+		peak_finder.find(peaks_map, clusters); }));
+
+	// Report ///////////////////////////////////////////////////////////////////
+	std::map <std::string, double> baseline;
+	if (!baseline_path.empty()) {
+		baseline = readBaseline(baseline_path);
+		if (baseline.empty())
+			std::cout << "# [bench_warning] No baseline in '" << baseline_path << "'\n";
+	}
+
+	std::ostringstream lines;
+	int n_regressions = 0;
+
+	for (int k = 0; k < results.size(); k++) {
+		const Result& result = results[k];
+		lines << "{\"name\":\"" << result.name << "\",\"ns\":" << result.time 
+		      << ",\"calls\":" << result.calls;
+
+		std::map <std::string, double>::iterator it = baseline.find(result.name);
+		if (it != baseline.end()) {
+			double change = 100 * (result.time / it->second - 1);
+			bool regression = change > tolerance;
+			n_regressions += regression;
+			lines << ",\"baseline\":" << it->second << ",\"change\":" << change 
+			      << ",\"regression\":" << (regression ? "true" : "false");
+		}
+		lines << "}\n";
+	}
+	std::cout << lines.str();
+
+	if (!save_path.empty()) {
+		std::ofstream file(save_path.c_str());
+		file << lines.str();
+		std::cout << "# Baseline saved to '" << save_path << "'\n";
+	}
+
+	if (n_regressions > 0) {
+		std::cout << "# [bench_error] " << n_regressions << " kernel(s) slower than the baseline by more than " 
+		          << tolerance << " % !\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////
+// End-to-end throughput of the host pipeline
+// ---------------------------------------------------------
+// Runs the demo's headless pipeline (decoding, resizing, 
+// tiling, board exchanges, stitching and detection) over
+// the KITTI sequence, against in-process boards timed like 
+// a ZTEX 2.16 : USB 2.0 bulk bandwidth, vendor commands on
+// the 125 us micro-frames, and the predicted device time of
+// the program. Reports the frames/s and the host CPU use.
+// usage : pipeline_bench [backend [n_frames [source]]]
+//         e.g. "fake:2:40:0.125:6" (see 'Interface')
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <sys/resource.h>
+
+#include "../include/Frame.h"
+#include "../include/Canva.h"
+#include "../include/FrameSource.h"
+#include "../include/Interface.h"
+#include "../include/Detector.h"
+#include "../include/Program.h"
+#include "../include/Model.h"
+#include "../include/Timer.h"
+
+static const double BANDWIDTH	= 40;		// MB/s (FX2-LP, bulk)
+static const double LATENCY		= 0.125;	// ms per vendor command
+
+// user + system time of the process (ms)
+double cpuTime() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3 + 
+		(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3;
+}
+
+int main(int argc, char* argv[]) {
+	const int N_OUT		= 3;
+	const char * ARCH	= "c9-p2-c9-p2-c9-p2-c9";
+
+	const int H_SIZE	= 720;
+	const int V_SIZE	= 240;
+
+	const char* program_path = "../coe/p_xz11.coe";
+	const char* kernels_path = "../coe/k_xz11.coe";
+
+	// one board, timed after the program
+	std::ostringstream fake;
+	fake << "fake:1:" << BANDWIDTH << ":" << LATENCY << ":" 
+	     << Program(Model::parseCoe(program_path)).time();
+
+	std::string backend = (argc > 1) ? argv[1] : fake.str();
+	int n_frames = (argc > 2) ? atoi(argv[2]) : 1000;
+	std::string source_spec = (argc > 3) ? argv[3] : "../data/kitti-51/";
+
+	std::cout << "# Backend : " << backend << "\n";
+
+	Interface CrayOn(ARCH, backend.c_str());
+	CrayOn.setLabelNb(N_OUT);
+	CrayOn.load(program_path, 'p');
+	CrayOn.load(kernels_path, 'k');
+
+	Detector detector(H_SIZE, V_SIZE);
+	detector.setStride(8);
+	Canva canva;
+
+	FrameSource* source = FrameSource::open(source_spec);
+	if (source == NULL)
+		return 1;
+
+	// same loop as the demo's, without the console output
+	Timer timer;
+	timer.reset();
+	double cpu_start = cpuTime();
+	int n_processed = 0;
+
+	for (; n_processed < n_frames; n_processed++) {
+		Frame input = source->next();
+		if (input.width() == 0) 
+			break;
+
+		canva.resizeCrop(input, CrayOn.input(), 0.64, H_SIZE, V_SIZE);
+		CrayOn.push();
+		CrayOn.process();
+
+		for (int i = 1; i < N_OUT; i++)
+			detector.pushHeatMap(CrayOn.pull(i));
+		detector.process();
+	}
+
+	double elapsed = timer.getMillisec();
+	double cpu = cpuTime() - cpu_start;
+	delete source;
+
+	if (n_processed == 0) {
+		std::cout << "# [bench_error] No frame in '" << source_spec << "' !\n";
+		return 1;
+	}
+
+	std::cout << "# Frames           : " << n_processed << "\n";
+	std::cout << "# Throughput       : " << 1e3 * n_processed / elapsed << " frames/s (" 
+	          << elapsed / n_processed << " ms / frame)\n";
+	std::cout << "# Host CPU         : " << 100 * cpu / elapsed << " % of a core (" 
+	          << std::thread::hardware_concurrency() << " cores), " 
+	          << cpu / n_processed << " ms / frame\n";
+	return 0;
+}
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////
+// Constant-time Gaussian blur
+// ---------------------------------------------------------
+// The Gaussian is approximated by 3 successive box filters 
+// whose widths give the requested deviation, each box being
+// a running sum: the cost per pixel does not depend on the
+// radius. Pixels outside of the frame count as zeros.
+// ---------------------------------------------------------
+// The boxes run down the columns, on whole lines at a time
+// (SSE2): the frame is filtered vertically, transposed, 
+// filtered again and transposed back.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "Frame.h"
+
+class Blur {
+ private :
+	static const int PASSES		= 3;
+	static const int MAX_WIDTH	= 255;	// box sums fit on 16 bits
+	static const int BLOCK		= 16;	// transposition blocks
+
+	int m_widths[PASSES];
+
+	std::vector <BYTE> m_buffers[3];
+	std::vector <uint16_t> m_sums;
+
+	void configure(double deviation);
+	void boxColumns(const BYTE* source, int stride, BYTE* target, int width, int height, int box);
+	void filterColumns(const BYTE* source, int stride, BYTE* target, int width, int height);
+	static void transpose(const BYTE* source, int stride, BYTE* target, int width, int height);
+
+ public :
+	Blur();
+	void apply(FrameView input, Frame& output, double deviation);
+};
@@ -4,6 +4,10 @@
 // Can be used to load, resize, and crop input frames before
 // sending them to the FPGA accelerator, as well as for the 
 // post-processing of the output heat maps.                  
+// The frames it builds come from its own pool, so that the
+// processing of a stream of frames does not allocate.
+// The filters read from views, so that they can be applied
+// to a crop without copying it first.
 ////////////////////////////////////////////////////////////
 
 #pragma once
@@ -12,16 +16,28 @@
 #include <iostream>
 #include <cmath>
 
-#include <SFML/Graphics.hpp>
 #include "Frame.h"
+#include "FramePool.h"
+#include "Resampler.h"
+#include "Blur.h"
+#include "Loader.h"
 
 class Canva {
+ private :
+	FramePool m_pool;
+	Resampler m_resampler;
+	Blur m_blur;
+
  public : 
 	Canva();
+	FramePool* pool();	// of the frames it builds
 	Frame load(const std::string& filename);
 	void blur(Frame& input, int radius, double sigma=0.25);
+	void blur(FrameView input, Frame& output, int radius, double sigma=0.25);
 	void normalize(Frame& input, int radius);
 	void resize(Frame& input, double scale);
-	void autoCrop(Frame& input, int width, int height);
-	void save(Frame& input, const std::string& filename);
+	void resize(FrameView input, Frame& output, double scale);
+	FrameView autoCrop(FrameView input, int width, int height);
+	void resizeCrop(FrameView input, Frame& output, double scale, int width, int height);
+	void save(FrameView input, const std::string& filename);
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////
+// Headless post-processing of the output heat maps
+// ---------------------------------------------------------
+// The heat maps are rectified and washed, then mixed into
+// a parsing (winner takes all, under a threshold nothing),
+// and the objects of each label are detected as clusters
+// of peaks. The detections are given in the coordinates of
+// the input frame, the maps being centered on it.
+// ---------------------------------------------------------
+// The detections of a frame can be written as a line of
+// JSON, or as binary records (native byte order):
+//   uint32 frame, uint32 count, 
+//   count x { uint32 label, float32 x, y, score }
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "Frame.h"
+#include "Canva.h"
+#include "PeakFinder.h"
+
+class Detector {
+ public :
+	struct Detection {
+		int label;		// 1 for the first heat map
+		float x;
+		float y;
+		float score;	// heat at the detection, in [0, 1]
+	};
+
+	enum Format { NDJSON, BINARY };
+
+ private :
+	static const int WASHING	= 4;
+	static constexpr double THRES	= 0.75;
+	static const int NMS_RADIUS	= 3;
+
+	int m_width;	// of the input frame
+	int m_height;
+	int m_stride;
+
+	Canva m_canva;	// first in, last out: the frames use its pool
+
+	std::vector <Frame> m_heat_maps;	// kept from a frame to the next
+	int m_n_heat_maps;
+
+	Frame m_parsing;	// labels, at the resolution of the maps
+	PeakFinder m_peak_finder;
+	std::vector <PeakFinder::Cluster> m_clusters;
+	std::vector <Detection> m_detections;
+
+	void refine();
+	void parse();
+	void detect();
+
+ public :
+	Detector(int width, int height);
+
+	void setStride(int stride);
+	void pushHeatMap(FrameView heat_map);
+	void process();
+
+	Frame& parsing();
+	int anchorX();
+	int anchorY();
+	const std::vector <Detection>& detections();
+
+	void write(std::ostream& stream, int frame, Format format);
+};
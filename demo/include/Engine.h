@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////
+// Bit-exact software model of the CrayOn processor
+// ---------------------------------------------------------
+// Executes the micro-programs and the kernels loaded from 
+// the i/o buffer, with the arithmetic of the FPGA design 
+// (VL=8, D=9, W=14, Fm=8, Fp=10, Wi=8):
+//  - maps are W bits wide (Fm fractional bits) and wrap,
+//  - weights are 12 bits wide, sign extended (Fp bits),
+//  - each combiner line truncates its partial sum to W bits,
+//  - the convolution results are aligned on the bottom-right
+//    tap, the input being streamed in raster order.
+// Like the Master, a propagation runs the program from its
+// first instruction up to its first jump.
+// ---------------------------------------------------------
+// The support of each pushed kernel (the bounding box of
+// its non-zero taps) is detected, so that the dead lines
+// and columns of the smaller or blank kernels are skipped.
+// The convolutions run on AVX2 when the CPU has it: the 
+// output planes of the VL NPUs are computed in turn over
+// the same input strip, 8 outputs at a time.
+// The NPU memories only span the slots addressed by the
+// loaded program, and the kernel memory can be shared by
+// several engines.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "Program.h"
+
+class Engine {
+ private :
+	static const int VL		= 8;	// ALU width
+	static const int D		= 9;	// convolution array dim.
+	static const int W		= 14;	// arith. precision
+	static const int Fm		= 8;	// fractional part - map values
+	static const int Fp		= 10;	// fractional part - parameters
+
+	static const int IO_DEPTH		= 76800;
+	static const int MAP_DEPTH		= 76800;
+	static const int ACTIV_DEPTH	= 19200;
+	static const int KERNEL_DEPTH	= 68000;
+	static const int PROGRAM_DEPTH	= 4096;
+
+	static const int STRIP			= 512;	// outputs per input strip
+	static const int PADDING		= 16;	// zeros after the input
+
+	struct Support {
+		int top, bottom;	// lines
+		int left, right;	// columns
+	};
+
+	Program m_program;
+	std::vector <int16_t> m_kernels;
+	const int16_t* m_kernel_memory;	// own or shared kernels
+
+	// NPUs memories
+	std::vector <int16_t> m_maps[VL];
+	std::vector <int16_t> m_activations[VL];
+	int m_map_depth;
+	int m_activation_depth;
+
+	// pushed kernels (row-major taps) and biases
+	int m_weights[VL][D * D];
+	int m_biases[VL];
+	Support m_support[VL];
+
+	// pairs of adjacent weights, from the left of the support
+	int32_t m_pairs[VL][D][(D + 1) / 2];
+
+	// P-bus
+	int m_payload;
+	bool m_fill_mode;
+	int m_cyclic_order;
+
+	std::vector <int16_t> m_source;
+	std::vector <int32_t> m_interleaved;	// pairs of adjacent inputs
+
+	bool m_vectorized;
+
+	static int wrap(int value);
+	static int activate(int value, int rect_mode);
+
+	void pushKernel(int kernel_index);
+	void convolve(const unsigned char* io, int input_index, int output_index, bool acc_mode);
+
+	template <int TAPS>
+	void convolveScalar(int n, int begin, int end, int width, int16_t* map, bool acc_mode);
+	void dispatchScalar(int n, int begin, int end, int width, int16_t* map, bool acc_mode);
+
+	template <int PAIRS>
+	void convolveVector(int n, int begin, int end, int width, int16_t* map, bool acc_mode);
+	void dispatchVector(int n, int begin, int end, int width, int16_t* map, bool acc_mode);
+
+	void fire(int input_index, bool pool_mode, int rect_mode);
+	void store(unsigned char* io, int store_index, int store_select);
+
+ public :
+	Engine();
+
+	void loadProgram(const unsigned char* io);
+	void loadKernels(const unsigned char* io, int chunk);
+	void propagate(unsigned char* io);
+
+	// read the kernels loaded in 'owner' from now on
+	void shareKernels(const Engine& owner);
+
+	void request(int request, unsigned char* io);
+
+	// AVX2 is used by default when available
+	void setVectorized(bool enabled);
+	bool vectorized();
+};
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////
+// Tile-parallel host execution of CrayOn programs
+// ---------------------------------------------------------
+// A pool of workers, each running its own 'Engine' on its
+// own i/o buffer. The tiles of a frame are split between 
+// the workers, which steal from each other once their own
+// share is over (from the same NUMA node first).
+// Workers are pinned to the cpus of the NUMA nodes listed
+// in sysfs, and allocate their memories themselves, so
+// that the pages are first touched on their node. The first
+// worker of each node holds the kernels of the node, which 
+// are shared by the other workers of that node.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "Engine.h"
+
+class Executor {
+ public :
+	// called by the workers, on the i/o buffer of a tile
+	typedef std::function <void (int tile, unsigned char* io)> Stage;
+
+ private :
+	static const int IO_SIZE = 76800;
+
+	struct Worker {
+		int index;
+		int node;
+		int cpu;
+		Worker* leader;	// first worker of the node
+
+		Engine* engine;
+		std::vector <unsigned char> io;
+
+		std::deque <int> tiles;
+		std::mutex mutex;
+		std::thread thread;
+	};
+
+	std::vector <Worker*> m_workers;
+
+	std::function <void (Worker&)> m_job;
+	std::mutex m_mutex;
+	std::condition_variable m_start;
+	std::condition_variable m_finish;
+	long m_generation;
+	int m_n_running;
+	bool m_running;
+
+	static std::vector <std::vector <int> > topology();
+	static std::vector <int> parseList(const std::string& list);
+
+	void work(Worker* worker);
+	void broadcast(const std::function <void (Worker&)>& job);
+	bool next(Worker& worker, int& tile);
+
+ public :
+	Executor(int n_workers = 0);	// one worker per cpu by default
+
+	int size();
+	int nodes();
+
+	// load requests, as raised to the board
+	void request(int request, const char* data);
+
+	void run(int n_tiles, const Stage& gather, const Stage& stitch);
+
+	~Executor();
+};
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////
+// In-process stand-in for the FX2-LP / CrayOn board
+// ---------------------------------------------------------
+// Implements the vendor protocol of the 'transceiver' 
+// firmware (0x80 - 0x83) on top of a local copy of the
+// 76800 bytes i/o buffer of the FPGA. Transfers are served 
+// in order by a worker thread, like on the real bus.
+// Interrupt requests are only counted: the board behaves
+// as a loopback.
+// Like the FPGA receiver, which only gets back to idle after
+// a whole payload, a vendor command coming after a partial
+// one is rejected (stall).
+// ---------------------------------------------------------
+// The board can also be given the timings of a real one: 
+// the bus bandwidth, the latency of the vendor commands and
+// the compute time of a request. The worker is then kept
+// busy accordingly, against a running deadline so that the
+// sleeping overhead does not add up.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "Link.h"
+
+class FakeLink : public Link {
+ public :
+	struct Timing {
+		double bandwidth;	// MB/s of the bulk transfers (0 : unlimited)
+		double latency;		// ms per vendor command
+		double compute;		// ms per interrupt request
+	};
+
+ private :
+	std::deque <Transfer*> m_queue;
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::thread m_worker;
+	bool m_running;
+
+	int m_mode;		// 0: the device receives, 1: the device transmits 
+	int m_cursor;	// position of the FPGA in the i/o buffer
+
+	std::atomic <int> m_n_requests;
+
+	Timing m_timing;
+	std::chrono::steady_clock::time_point m_deadline;	// the worker is busy until then
+
+	static const int MEMORY_SIZE = 76800;
+	std::vector <char> m_memory;
+
+	void run();
+	void serve(Transfer* transfer);
+	void spend(double time);
+
+ public :
+	FakeLink(Timing timing = Timing());
+
+	int submit(Transfer* transfer);
+	bool synchronous();
+	int requestCount();
+
+	~FakeLink();
+};
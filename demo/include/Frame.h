@@ -1,6 +1,15 @@
 ////////////////////////////////////////////////////////////
 // Simple class implementing a 2-dimensional short array.  
 // We used it for manipulating data frame buffers.
+// ---------------------------------------------------------
+// The buffers are 64-byte aligned and only grow: resizing 
+// or assigning a frame reuses its buffer when it is large
+// enough, and moving a frame hands its buffer over. 
+// A frame built on a 'FramePool' gives its buffer back to 
+// the pool instead of freeing it. A frame never changes its
+// pool: moving it onto a frame of another pool copies it.
+// 'view' gives a window over the frame without any copy,
+// assigning a view to a frame copies its pixels.
 ////////////////////////////////////////////////////////////
 
 #pragma once
@@ -8,31 +17,49 @@
 #include <iostream>
 #include <stdint.h>
 #include <cstdlib>
+#include <atomic>
+
+#include "FrameView.h"
 
 typedef unsigned char BYTE;
 
+class FramePool;
+
 class Frame {
  private :
+	static const int ALIGNMENT = 64;
+	static std::atomic <long> s_allocations;
+
 	int m_width;
 	int m_height;
+	int m_capacity;
 	BYTE* m_data;
+	FramePool* m_pool;	// where the buffer goes back to
+
+	void reserve(int size);
+	void release();
 
  public :
 	// Construction ////////////////////////////////////////
 	Frame();
-	Frame(int width, int height);
+	Frame(int width, int height, FramePool* pool = NULL);
 	Frame(const Frame &frame);
+	Frame(Frame &&frame) noexcept;
 
 	// Base functions //////////////////////////////////////
 	int width();
 	int height();
+	FramePool* pool();
 
 	BYTE& operator()(int x, int y);
 	Frame& operator=(const Frame &frame);
+	Frame& operator=(Frame &&frame) noexcept;
+	Frame& operator=(FrameView view);
 
 	// Raw data manipulation ///////////////////////////////
 	void load(BYTE* data);
 	BYTE* data();
+	FrameView view(int anchor_x, int anchor_y, int width, int height);
 	
 	// Advanced functions //////////////////////////////////
 	Frame& realloc(int width, int height);
@@ -40,6 +67,9 @@ class Frame {
 	Frame& fill(int value);
 	Frame& complement() ;
 
+	// buffers allocated so far, by all the frames
+	static long allocations();
+
 	// Destruction /////////////////////////////////////////
 	~Frame();
-};
\ No newline at end of file
+};
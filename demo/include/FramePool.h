@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////
+// Recycling pool of frame buffers. The frames built on the
+// pool take the smallest free buffer that fits, and give it
+// back on destruction, so that a steady flow of frames does
+// not allocate anything once the pool is warm. 
+// The pool must outlive its frames.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <map>
+#include <mutex>
+
+#include "Frame.h"
+
+class FramePool {
+ private :
+	std::multimap <int, BYTE*> m_free;	// by capacity
+	std::mutex m_mutex;
+
+ public :
+	FramePool();
+
+	// NULL if no free buffer holds 'size' bytes
+	BYTE* acquire(int size, int& capacity);
+	void release(BYTE* buffer, int capacity);
+
+	int size();
+	~FramePool();
+};
@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////
+// Abstract source of grayscale input frames
+// ---------------------------------------------------------
+// 'next' hands the frames over in order, and an empty frame
+// (0 x 0) once the source is exhausted. The sources read 
+// ahead in the background, up to 'depth' frames, and hold 
+// on when the consumer falls behind (back-pressure).
+// 'open' picks the source from its specification :
+//   <directory>/           numbered images (PNG), in order
+//   <file>.y4m, -          YUV4MPEG2 video (luma), '-' : stdin
+//   raw:<w>x<h>:<file|->   raw 8 bits grey frames
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+
+#include "Frame.h"
+
+class FrameSource {
+ public :
+	virtual Frame next() = 0;
+
+	// NULL if the source cannot be opened
+	static FrameSource* open(const std::string& spec, int depth = 4);
+
+	virtual ~FrameSource() {}
+};
@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////
+// Non-owning window over the pixels of a frame (or of any
+// 8-bit buffer), whose lines are 'stride' bytes apart.
+// Cropping a view is free: the pixels are only read when 
+// the view is consumed, by a filter or a copy into a frame.
+// The viewed buffer must outlive the view.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <iostream>
+#include <cstdlib>
+
+typedef unsigned char BYTE;
+
+class Frame;
+
+class FrameView {
+ private :
+	BYTE* m_data;
+	int m_width;
+	int m_height;
+	int m_stride;
+
+ public :
+	FrameView();
+	FrameView(Frame& frame);
+	FrameView(BYTE* data, int width, int height, int stride);
+
+	int width();
+	int height();
+	int stride();
+
+	BYTE& operator()(int x, int y);
+	BYTE* line(int y);
+	BYTE* data();
+
+	FrameView crop(int anchor_x, int anchor_y, int width, int height);
+};
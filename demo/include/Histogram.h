@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////
+// Latency histogram, HDR-style : the buckets are linear 
+// within each power of two, so that any value is known 
+// within 1/SUB_BUCKETS (3 %), from 1 ns to 2^40 ns (18 min). 
+// The buckets are fixed and counted atomically: recording
+// never allocates nor locks, from any number of threads.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+class Histogram {
+ private :
+	static const int SUB_BITS		= 5;
+	static const int SUB_BUCKETS	= 1 << SUB_BITS;
+	static const int MAX_BITS		= 40;
+	static const int N_BUCKETS		= (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+	std::atomic <uint64_t> m_counts[N_BUCKETS];
+	std::atomic <uint64_t> m_count;
+	std::atomic <uint64_t> m_sum;	// ns
+
+	static int bucket(uint64_t value);
+	static uint64_t highest(int bucket);
+
+ public :
+	Histogram();
+
+	void record(uint64_t value);	// ns
+	void reset();
+
+	uint64_t count() const;
+	uint64_t sum() const;
+	uint64_t percentile(double quantile) const;	// ns, 0 if empty
+};
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////
+// Numbered images of a directory, as a frame source
+// ---------------------------------------------------------
+// The PNG files are listed once, and taken in the order of
+// their names (zero padded numbers). The 'Loader' decodes
+// them ahead; a file that cannot be decoded is skipped.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+
+#include "FrameSource.h"
+#include "Loader.h"
+
+class ImageSource : public FrameSource {
+ private :
+	Loader m_loader;
+	int m_n_files;
+	int m_n_taken;
+
+	ImageSource(int depth);
+
+ public :
+	// NULL if the directory holds no image
+	static ImageSource* open(const std::string& directory, int depth = 4);
+
+	Frame next();
+};
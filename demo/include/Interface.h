@@ -4,6 +4,10 @@
 // Pre-process input frames, send them to the FPGA board.   
 // Then pull back the result packets to the host, assemble  
 // them, and finally fine tune the obtained frame parsing   
+// ---------------------------------------------------------
+// Backends : 'usb' (every board found), 'fake:<n>' (n
+// in-process boards) or 'cpu[:<n>]' (the software model,
+// on all the cores or n workers).
 ////////////////////////////////////////////////////////////
 
 #pragma once
@@ -13,21 +17,75 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <map>
 
 #include "Timer.h"
 #include "Frame.h"
+#include "Queue.h"
+#include "Program.h"
+#include "Model.h"
 #include "Transceiver.h"
+#include "UsbLink.h"
+#include "FakeLink.h"
+#include "Executor.h"
+#include "Histogram.h"
 
 class Interface {
+ public :
+	enum Stage { TX, DEVICE, RX, STITCH, N_STAGES };
+
  private :
 	static const int MEM_WIDTH	= 320;
 	static const int MEM_HEIGHT	= 240;
 
-	Transceiver m_transceiver;
-	
 	static const int TX_PAYLOAD	= 76800;
 	static const int RX_PAYLOAD	= 15360;
 
+	static const int TX_SLOTS	= 3;	// per board
+	static const int RX_SLOTS	= 2;
+
+	struct Board;
+
+	struct Residency {
+		uint32_t program;	// content hashes (0 : unknown)
+		uint32_t kernels;
+	};
+
+	struct Slot {
+		int tile;
+		char* buffer;
+		Board* board;
+	};
+
+	struct Board {
+		Transceiver transceiver;
+
+		char* tx_slots[TX_SLOTS];
+		char* rx_slots[RX_SLOTS];
+
+		Queue <char*> tx_free;
+		Queue <char*> rx_free;
+		Queue <Slot> assigned;		// gathered tiles, to be sent
+
+		std::atomic <int> load;		// tiles assigned, not read back yet
+		bool lost;
+		Residency resident;
+		std::thread driver;
+
+		Board(Link* link);
+		~Board();
+	};
+
+	// each tile goes to the board with the fewest tiles in
+	// progress, the memories being loaded on all of them
+	std::vector <Board*> m_boards;
+
+	// the tiles run on the host, in parallel: the 'cpu' backend,
+	// or the fallback once all the boards are lost
+	Executor* m_executor;
+
 	int m_rows;
 	int m_cols;
 
@@ -36,6 +94,17 @@ class Interface {
 	Frame m_tile_in;
 	Frame m_tile_out;
 
+	// 3 stages pipeline: a thread gathers the tiles, a thread
+	// per board drives it, and another one stitches the results,
+	// the buffer slots going through bounded queues
+	Queue <int> m_frames;			// tile count of the frames to gather
+	Queue <Slot> m_received;
+	Queue <int> m_stitched;		// end of frame notifications
+	std::atomic <int> m_n_pending;	// tiles of the frame left to stitch
+
+	std::thread m_gatherer;
+	std::thread m_stitcher;
+
 	std::vector <Frame> m_outputs;
 
 	int m_spare;
@@ -44,19 +113,77 @@ class Interface {
 	Timer m_timer;
 	double m_delay;
 
-	void loadInputTile(int i, int j);
-	void fillOutputTile(int i, int j, int label);
+	Histogram m_latencies[N_STAGES];	// per tile, over all the boards
+
+	Program m_program;
+	std::string m_program_path;
+
+	struct Entry {
+		Model* model;
+		Program program;
+		std::string path;	// of the program
+		double delay;		// device time
+	};
+
+	// the models are registered by content, and the sections
+	// resident on each board are tracked: switching between
+	// networks only uploads what has changed
+	std::map <uint64_t, Entry> m_registry;	// by content hash
+	uint64_t m_current;
+	Residency m_host_resident;	// of the executor
+	double m_switch_time;
+
+	void loadInputTile(int i, int j, char* slot);
+	void fillOutputTile(int i, int j, int label, const BYTE* tile);
 	void updateGrid();
 
+	long sendTile(Board* board, char* slot);
+
+	Board* leastLoaded();
+	void gather();
+	void drive(Board* board);
+	void stitch();
+	void probe(char* tile, double delay, char* result);
+
+	uint64_t insert(Model* model, const std::string& path);
+	int upload(Model* model);
+	void uploadBoard(Board* board, Model* model);
+	void request(Board* board, const char* data, int size, int request);
+	void fallback();
+
+	static std::vector <Link*> openLinks(const char* backend);
+
  public :
-	Interface(const char * descriptor);
+	Interface(const char * descriptor, const char * backend = "usb");
+	~Interface();
 
 	void load(const char* filename, char mode);
+
+	// model registry
+	uint64_t add(const char* filename);
+	uint64_t add(const char* program, const char* kernels);
+	void use(uint64_t model);
+	uint64_t current();
+	double switchTime();	// of the last 'use' (ms)
+	
+	void push(FrameView frame);
 	
-	void push(const Frame& frame);
+	// the input frame can also be written in place, then pushed
+	Frame& input();
+	void push();
 	void process();
 	Frame& pull(int label = 0);
 
+	double tune();
+
+	// host side of a tile : complemented into a transfer slot,
+	// and stitched back from one (76800 bytes)
+	void gatherTile(int tile, char* slot);
+	void receiveTile(int tile, char* slot);
+	int tileCount();
+
+	const Histogram& latency(Stage stage);
+
 	void setLabelNb(int number);
 	void setDelay(double delay);
 	void setArch(const char * descriptor);
@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////
+// Abstract link towards a device running the 'transceiver'
+// firmware. Transfers are submitted asynchronously and are
+// completed, in submission order, from the link's own
+// event thread.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+#include "Transfer.h"
+
+// Vendor commands of the 'transceiver' firmware
+enum {
+	CMD_SEND	= 0x80,	// the device receives the next bulk out
+	CMD_RECEIVE	= 0x81,	// the device transmits on the next bulk in
+	CMD_REQUEST	= 0x82,	// raise an interrupt request to CrayOn
+	CMD_RESET	= 0x83	// reset the FIFOs and the FPGA logic
+};
+
+class Link {
+ public :
+	// returns a negative value if the transfer was not queued
+	virtual int submit(Transfer* transfer) = 0;
+
+	// buffers suited for DMA with this link
+	virtual char* alloc(int size);
+	virtual void release(char* buffer, int size);
+
+	// true if a request is over before the next transfer is served
+	virtual bool synchronous();
+
+	virtual ~Link() {}
+};
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////
+// Grayscale PNG loader, decoding straight into frames with
+// libpng (no RGBA expansion).
+// ---------------------------------------------------------
+// The files of a sequence are enqueued in order, and are
+// decoded in the background by a few workers, up to 'depth'
+// frames ahead of the one being processed. 'next' hands the
+// frames over in the enqueuing order, a frame that could
+// not be decoded being empty (0 x 0).
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <deque>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Frame.h"
+#include "FramePool.h"
+
+class Loader {
+ private :
+	struct Job {
+		int index;
+		std::string filename;
+	};
+
+	int m_depth;
+	FramePool m_pool;
+
+	std::deque <Job> m_jobs;
+	std::map <int, Frame> m_decoded;	// by sequence index
+	int m_n_enqueued;
+	int m_next;		// index of the next frame handed over
+	bool m_running;
+
+	std::mutex m_mutex;
+	std::condition_variable m_jobs_ready;
+	std::condition_variable m_frame_ready;
+
+	std::vector <std::thread> m_workers;
+
+	void work();
+
+ public :
+	Loader(int depth = 4, int n_workers = 2);
+
+	static bool decode(const std::string& filename, Frame& frame);
+
+	void enqueue(const std::string& filename);
+	Frame next();
+
+	~Loader();
+};
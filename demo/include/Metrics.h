@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////
+// Metrics exporter, in the Prometheus text format
+// ---------------------------------------------------------
+// The registered histograms, counters and gauges are read
+// every 'period' by a background thread, and written to a
+// textfile (e.g. for the node exporter's textfile collector).
+// The file is replaced atomically (rename), so that a reader
+// never sees a partial export. Histograms are exported as
+// summaries (p50, p99, p999, in seconds). A 'rate' is the
+// per second increase of a counter over the last period.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "Histogram.h"
+
+class Metrics {
+ private :
+	enum Kind { SUMMARY, COUNTER, GAUGE, RATE };
+
+	struct Metric {
+		Kind kind;
+		std::string name;
+		std::string help;
+		const Histogram* histogram;
+		std::function <double ()> value;
+		double last;	// of a rate's counter
+	};
+
+	std::string m_filename;
+	int m_period;	// ms
+
+	std::vector <Metric> m_metrics;
+	uint64_t m_last_export;	// ns
+
+	std::thread m_exporter;
+	std::mutex m_mutex;
+	std::condition_variable m_stop;
+	bool m_running;
+
+	void add(Kind kind, const std::string& name, const std::string& help, 
+		const Histogram* histogram, const std::function <double ()>& value);
+	void run();
+
+ public :
+	Metrics(const std::string& filename, int period = 1000);
+
+	void summary(const std::string& name, const std::string& help, const Histogram& histogram);
+	void counter(const std::string& name, const std::string& help, const std::function <double ()>& value);
+	void gauge(const std::string& name, const std::string& help, const std::function <double ()>& value);
+	void rate(const std::string& name, const std::string& help, const std::function <double ()>& counter);
+
+	void start();
+	bool write();
+
+	~Metrics();
+};
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////
+// CrayOn model : a micro-program and its kernels
+// ---------------------------------------------------------
+// The sections hold the byte images sent to the board (16
+// bits words, MSB first), padded to whole load requests, so
+// that they can be streamed as is into the transfers.
+// Models are either mapped from a binary file, or built in
+// memory from the textual .coe files.
+// Binary layout (host byte order) :
+//   header  : 64 bytes, see below
+//   program : at 'program_offset', 'program_size' bytes
+//   kernels : at 'kernels_offset', 'kernels_size' bytes
+// The sections start on page boundaries, and each of them,
+// like the header, is protected by a CRC-32. The CRCs of the
+// sections also identify their content.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+class Model {
+ public :
+	static const int PROGRAM_CHUNK	= 8192;		// bytes per program load
+	static const int KERNELS_CHUNK	= 65536;	// bytes per kernels load
+
+ private :
+	static const int VERSION		= 1;
+	static const int ALIGNMENT		= 4096;
+
+	struct Header {
+		char magic[8];			// "CRAYON\0\0"
+		uint32_t version;
+		uint32_t header_size;
+		uint32_t program_words;
+		uint32_t program_offset;
+		uint32_t program_size;
+		uint32_t program_crc;
+		uint32_t kernels_words;
+		uint32_t kernels_offset;
+		uint32_t kernels_size;
+		uint32_t kernels_crc;
+		uint32_t reserved[3];
+		uint32_t header_crc;	// of the previous fields
+	};
+
+	// mapped file
+	char* m_map;
+	size_t m_map_size;
+
+	// sections built in memory
+	std::vector <char> m_program_image;
+	std::vector <char> m_kernels_image;
+
+	const char* m_program;
+	int m_program_size;
+	int m_program_words;
+	uint32_t m_program_crc;
+
+	const char* m_kernels;
+	int m_kernels_size;
+	int m_kernels_words;
+	uint32_t m_kernels_crc;
+
+	static std::vector <char> image(const std::vector <int>& words, int chunk);
+	static std::vector <uint32_t> crcTable();
+	void unmap();
+
+ public :
+	Model();
+
+	void open(const char* filename);
+	void save(const char* filename);
+
+	void setProgram(const std::vector <int>& words);
+	void setKernels(const std::vector <int>& words);
+
+	// copy a section of another model
+	void copyProgram(Model& source);
+	void copyKernels(Model& source);
+
+	bool hasProgram();
+	bool hasKernels();
+
+	const char* program();
+	int programSize();		// bytes, whole chunks
+	std::vector <int> programWords();
+
+	const char* kernels();
+	int kernelsSize();		// bytes, whole chunks
+
+	// content hashes (0 for an empty section)
+	uint32_t programHash();
+	uint32_t kernelsHash();
+	uint64_t hash();
+
+	static std::vector <int> parseCoe(const char* filename);
+	static uint32_t checksum(const char* data, size_t size, uint32_t crc = 0);
+
+	~Model();
+};
@@ -1,7 +1,18 @@
 ////////////////////////////////////////////////////////////
 // This tool can be used to mix the different heat maps, 
 // using a winner's take all policy and to superpose the 
-// resulting parsing to the input image.
+// resulting parsing to the input image. The maps are 
+// processed by a 'Detector', the monitor only draws.
+// The blended colors are tabulated per label and input 
+// level, and the screen is written line by line into a
+// pixel buffer that updates a persistent texture.
+// ---------------------------------------------------------
+// The monitor runs on its own thread, which owns the window.
+// 'update' posts the frame to a single slot mailbox and
+// returns at once: a frame not yet taken by the display is
+// replaced (dropped) by the next one. The stride and zoom
+// go along with the frame, and the closing of the window
+// comes back the same way ('closed').
 // ---------------------------------------------------------
 // The rendering of the resulting frame is based upon 
 // the Standard and Fast Multimedia Library (SFML 2.3)
@@ -9,12 +20,20 @@
 
 #pragma once
 
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include <SFML/Graphics.hpp>
 #include "Frame.h"
-#include "Canva.h"
+#include "Timer.h"
+#include "Detector.h"
 #include "Target.h"
 
-static const sf::Color palette[5] = {
+static const int PALETTE_SIZE = 5;
+
+static const sf::Color palette[PALETTE_SIZE] = {
 	sf::Color::Blue, 
 	sf::Color::Red, 
 	sf::Color::Yellow,
@@ -24,34 +43,66 @@ static const sf::Color palette[5] = {
 
 class Monitor {
  private :
- 	static const int WASHING  = 4;		
- 	static const double THRES = 0.75;	
-  	static const double RATIO = 0.25;
+  	static constexpr double RATIO = 0.25;
  	
- 	int m_zoom;
+ 	int m_zoom;		// of the next posts
 	int m_stride;
-	
+	int m_width;
+	int m_height;
+
+	struct Post {
+		Frame input;
+		std::vector <Frame> heat_maps;
+		int n_heat_maps;
+		int stride;
+		int zoom;
+		float time;		// of the post
+	};
+
+	Post m_staging;		// being filled by the producer
+	Post m_mailbox;
+	Post m_shown;		// being displayed
+	bool m_full;
+	bool m_running;
+	bool m_closed;		// by the user
+
+	std::mutex m_mutex;
+	std::condition_variable m_posted;
+	std::thread m_renderer;
+
+	Timer m_clock;
+	int m_n_dropped;
+	int m_n_displayed;
+	double m_latency;	// total, from the posts to the displays
+
 	Frame m_input;
-	std::vector <Frame> m_heat_maps;
-	Frame m_parsing;
+	Detector m_detector;
+
+	sf::Uint8 m_blended[PALETTE_SIZE][256][4];	// RGBA, by label and level
+	std::vector <sf::Uint8> m_pixels;
+	std::vector <int> m_map_columns;	// of the screen columns (-1 : none)
 
-	sf::Image m_screen_image;
 	sf::Texture m_screen_texture;
 	sf::Sprite m_screen_sprite;
 	sf::RenderWindow m_window;
 
-	Canva m_canva;
 	sf::Color blend(sf::Color a, sf::Color b, double ratio);
 
-	void refine();
 	void process();
+	void render();
 
  public :
 	Monitor(int width, int height);
 	void update();
+
+	int dropped();
+	double latency();	// mean, in ms
+	bool closed();
 	
 	void setStride(int stride);
-	void setInput(Frame& input);
-	void pushHeatMap(Frame& heat_map);
+	void setInput(FrameView input);
+	void pushHeatMap(FrameView heat_map);
 	void setZoom(int zoom);
+
+	~Monitor();
 };
\ No newline at end of file
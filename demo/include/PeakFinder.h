@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////
+// Detection of the objects in a heat map
+// ---------------------------------------------------------
+// A peak is a pixel above the threshold that is the maximum
+// of the (2r+1) x (2r+1) window centered on it. The window 
+// maxima come from a separable running max (van Herk / Gil-
+// Werman: 3 comparisons per pixel, whatever the radius).
+// The peaks are then merged into clusters: a peak joins the
+// first cluster closer than r on both axes, the clusters 
+// being looked up in a grid of r x r cells. 
+// Both steps are linear in the size of the map.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+#include "Frame.h"
+
+class PeakFinder {
+ public :
+	struct Cluster {
+		float x;
+		float y;
+		int count;	// merged peaks
+	};
+
+ private :
+	int m_radius;
+	double m_threshold;
+
+	std::vector <BYTE> m_maxima;	// of the windows, along the lines
+	std::vector <BYTE> m_prefix;
+	std::vector <BYTE> m_suffix;
+
+	int m_grid_width;
+	std::vector <std::vector <int> > m_cells;	// clusters in each cell
+
+	void runningMax(const BYTE* input, int step, int length, BYTE* output, int output_step);
+	int cell(float x, float y);
+	void merge(int x, int y, std::vector <Cluster>& clusters);
+
+ public :
+	PeakFinder(int radius = 3, double threshold = 191.25);
+	void find(FrameView map, std::vector <Cluster>& clusters);
+
+	void setRadius(int radius);
+	void setThreshold(double threshold);
+};
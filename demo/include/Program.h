@@ -0,0 +1,46 @@
+////////////////////////////////////////////////////////////
+// Decoded CrayOn micro-program
+// ---------------------------------------------------------
+// Each 16 bits word holds a 4 bits opcode and a 12 bits 
+// operand, as decoded by the Master state machine. Besides
+// the decoding, this class estimates the number of cycles
+// spent by the Master to run the program once, from the
+// hold times of its state machine, and the extent of the
+// NPU memories it addresses.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+class Program {
+ private :
+	std::vector <int> m_words;
+
+ public :
+	enum Opcode { JUMP = 0, CONFIG = 1, PUSH_KERNEL = 2, CONVOLVE = 3, FIRE = 4, STORE = 5 };
+
+	static const int VL		= 8;	// ALU width
+	static const int D		= 9;	// convolution array dim.
+	static const int TAU	= 5;	// minimum hold time
+	static constexpr double CLOCK = 150e6; // CrayOn clock (Hz)
+
+	Program();
+	Program(const std::vector <int>& words);
+
+	int size();
+	int opcode(int address);
+	int operand(int address);
+
+	int length();
+	long cycles(int address, int payload);
+	long cycles();
+	double time();
+
+	int mapDepth();
+	int activationDepth();
+
+	static int blockWidth(int payload);
+	static int blockSize(int payload);
+};
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////
+// Bounded blocking queue, used to chain the stages of the
+// tile pipeline. 'push' holds on while the queue is full, 
+// and 'pop' while it is empty, unlike 'tryPop'.
+// The items are moved in and out. Once 'close'd, the queue
+// is drained and then ends: 'pop(item)' returns false.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+template <typename T>
+class Queue {
+ private :
+	std::deque <T> m_items;
+	size_t m_capacity;
+	bool m_closed;
+
+	std::mutex m_mutex;
+	std::condition_variable m_not_empty;
+	std::condition_variable m_not_full;
+
+ public :
+	Queue(int capacity) : m_capacity(capacity), m_closed(false) {}
+
+	void push(T item) {
+		std::unique_lock <std::mutex> lock(m_mutex);
+		while (m_items.size() >= m_capacity)
+			m_not_full.wait(lock);
+		m_items.push_back(std::move(item));
+		m_not_empty.notify_one();
+	}
+
+	T pop() {
+		std::unique_lock <std::mutex> lock(m_mutex);
+		while (m_items.empty())
+			m_not_empty.wait(lock);
+		T item = std::move(m_items.front());
+		m_items.pop_front();
+		m_not_full.notify_one();
+		return item;
+	}
+
+	// false once closed and empty
+	bool pop(T& item) {
+		std::unique_lock <std::mutex> lock(m_mutex);
+		while (m_items.empty() && !m_closed)
+			m_not_empty.wait(lock);
+		if (m_items.empty())
+			return false;
+		item = std::move(m_items.front());
+		m_items.pop_front();
+		m_not_full.notify_one();
+		return true;
+	}
+
+	bool tryPop(T& item) {
+		std::lock_guard <std::mutex> lock(m_mutex);
+		if (m_items.empty())
+			return false;
+		item = std::move(m_items.front());
+		m_items.pop_front();
+		m_not_full.notify_one();
+		return true;
+	}
+
+	void close() {
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_closed = true;
+		m_not_empty.notify_all();
+	}
+
+	int size() {
+		std::lock_guard <std::mutex> lock(m_mutex);
+		return m_items.size();
+	}
+};
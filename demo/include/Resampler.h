@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////
+// Separable fixed-point image resampler
+// ---------------------------------------------------------
+// Each output column (resp. line) is a weighted sum of a few
+// input columns (resp. lines), the indices and the 8.8 fixed
+// point weights being tabulated once per geometry. Indices 
+// are clamped on the edges, and the weights of a tap set
+// always sum to 1 (256).
+// Downscales average the covered input area, other scales 
+// interpolate bilinearly (pixel centers are aligned).
+// When only a window of the resized frame is wanted, only
+// the input pixels it covers are processed.
+// ---------------------------------------------------------
+// The frame is processed line by line: the input lines are
+// first blended on SSE2 (AVX2 when the CPU has it), then
+// the blended line is resampled from the tables.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "Frame.h"
+
+class Resampler {
+ private :
+	// taps of the output coordinates along an axis
+	struct Axis {
+		int taps;
+		std::vector <int> index;		// 'taps' per output
+		std::vector <uint16_t> weight;
+
+		// outputs from 'offset' on
+		void bilinear(int n_inputs, int offset, int n_outputs, double scale);
+		void area(int n_inputs, int offset, int n_outputs, double scale);
+	};
+
+	Axis m_columns;
+	Axis m_lines;
+
+	int m_width;	// geometry of the tables
+	int m_height;
+	double m_scale;
+	int m_out_width;
+	int m_out_height;
+	int m_first_column;
+
+	std::vector <BYTE*> m_sources;	// the input lines of an output line
+	std::vector <BYTE> m_blended;
+	bool m_vectorized;
+
+	void configure(int width, int height, double scale, int out_width, int out_height);
+
+	// blend the columns from 'x' to 'width'
+	void blendScalar(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target);
+	void blendVector(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target);
+	void blendWide(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target);
+
+	template <int TAPS> 
+	void resampleLine(const BYTE* blended, int width, BYTE* target);
+
+ public :
+	Resampler();
+	void resize(FrameView input, Frame& output, double scale);
+
+	// the centered window of the resized input, only
+	void resize(FrameView input, Frame& output, double scale, int width, int height);
+
+	void setVectorized(bool enabled);
+	bool vectorized();
+};
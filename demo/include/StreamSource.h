@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////
+// Video stream, read from a file or a pipe (stdin)
+// ---------------------------------------------------------
+// Either 8 bits YUV4MPEG2, of which only the luma plane is
+// kept, or raw 8 bits grey frames of a given size. A thread reads
+// the stream sequentially into pooled frames, and queues up
+// to 'depth' of them; it holds on while the queue is full.
+// The stream ends at the end of the file (or of the pipe).
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "FrameSource.h"
+#include "FramePool.h"
+#include "Queue.h"
+
+class StreamSource : public FrameSource {
+ public :
+	enum Format { Y4M, RAW };
+
+ private :
+	FILE* m_file;
+	Format m_format;
+
+	int m_width;
+	int m_height;
+	int m_skipped;	// chroma bytes per frame (Y4M)
+	std::vector <char> m_scratch;
+
+	FramePool m_pool;
+	Queue <Frame> m_frames;		// closed at the end of the stream
+
+	std::thread m_reader;
+	std::atomic <bool> m_running;
+
+	StreamSource(FILE* file, Format format, int depth);
+
+	bool readHeader();
+	bool readFrame(Frame& frame);
+	void read();
+
+ public :
+	// NULL if the stream cannot be opened or is not valid
+	static StreamSource* open(const std::string& filename, Format format, 
+		int width, int height, int depth = 4);
+
+	Frame next();
+
+	~StreamSource();
+};
@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////
+// This file has been mechanically generated from the
+// OffsetTable.vhd and SlopeTable.vhd look-up tables of the
+// piece-wise linear hyperbolic tangent (values in Q.12, 
+// indexed by the 10 bits sign-extended msb of the input)
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+static const int TANH_OFFSET[1024] = {
+	0, 1003, 1892, 2601, 3119, 3474, 3707, 3855,
+	3948, 4005, 4041, 4062, 4075, 4083, 4088, 4091,
+	4093, 4094, 4094, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+	4095, 4095, 4095, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4096, -4096,
+	-4096, -4096, -4096, -4096, -4096, -4096, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4095, -4095,
+	-4095, -4095, -4095, -4095, -4095, -4095, -4094, -4094,
+	-4093, -4091, -4088, -4083, -4075, -4062, -4041, -4005,
+	-3948, -3855, -3707, -3474, -3119, -2601, -1892, -1003,
+};
+
+static const int TANH_SLOPE[1024] = {
+	4012, 3558, 2834, 2071, 1420, 931, 593, 371,
+	229, 140, 85, 52, 31, 19, 11, 7,
+	4, 2, 1, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 1, 2, 4,
+	7, 11, 19, 31, 52, 85, 140, 229,
+	371, 593, 931, 1420, 2071, 2834, 3558, 4012,
+};
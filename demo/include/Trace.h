@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////
+// Span recorder, dumped in the Chrome trace format (JSON),
+// as read by chrome://tracing or Perfetto
+// ---------------------------------------------------------
+// A 'Span' records the time its scope took, on a monotonic
+// clock, when tracing is enabled. Each thread records into 
+// its own buffer without any lock: the buffer is only ever
+// appended to by its thread, and the number of recorded 
+// events is published for the dump. A full buffer drops the
+// new events. The span names must be string literals.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Trace {
+ private :
+	static const int CAPACITY = 1 << 16;	// events per thread
+
+	struct Event {
+		const char* name;
+		int id;			// tile, frame ... (-1 : none)
+		uint64_t begin;	// ns
+		uint64_t end;
+	};
+
+	struct Buffer {
+		int thread;
+		std::string name;
+		std::vector <Event> events;
+		std::atomic <int> size;
+		std::atomic <long> dropped;
+	};
+
+	static std::atomic <bool> s_enabled;
+	static std::mutex s_mutex;
+	static std::vector <Buffer*> s_buffers;	// kept until the end
+
+	static Buffer* buffer();
+
+ public :
+	static uint64_t now();
+
+	static void enable(bool enabled);
+	static bool enabled();
+
+	static void record(const char* name, int id, uint64_t begin, uint64_t end);
+	static void setThreadName(const std::string& name);
+
+	static bool dump(const char* filename);
+};
+
+class Span {
+ private :
+	const char* m_name;
+	int m_id;
+	uint64_t m_begin;	// 0 : not traced
+
+ public :
+	Span(const char* name, int id = -1);
+	~Span();
+};
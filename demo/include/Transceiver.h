@@ -1,5 +1,18 @@
 ////////////////////////////////////////////////////////////
 // Simple class for hosting FX2-LP usb devices              
+// ---------------------------------------------------------
+// Every exchange with the board is queued as a sequence of
+// transfers. A vendor command acts as a barrier, while the
+// slices of a bulk payload are kept in flight together on
+// their endpoint. The 'submit' methods return a ticket,
+// which can be waited for with 'complete()', so that the
+// host can keep working while the bus is busy.
+// Finally 'wait()' holds on until an interrupt request has
+// been processed, without counting twice the host work
+// done since the request reached the board.
+// The bus time of each payload, from its first slice going
+// out to its last one being served, can be recorded into 
+// histograms ('observe').
 ////////////////////////////////////////////////////////////
 
 #pragma once
@@ -8,13 +21,23 @@
 #include <cstdlib> 
 #include <cstring>
 
-#include <usb.h>
-
 #include <string.h>
 #include <iostream>
+#include <deque>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+
+#include "Link.h"
+#include "Timer.h"
+#include "Histogram.h"
 
 class Transceiver {
  private :
+	static const int SLICE = 16384;	// bulk slice size (bytes)
+	static const int DEPTH = 4;		// slices in flight per endpoint
 
 	int m_rx_payload;
 	int m_tx_payload;
@@ -22,17 +45,38 @@ class Transceiver {
 	char* m_rx_buffer;
 	char* m_tx_buffer;
 
-	const char* m_id;
+	Link* m_link;
+	std::map <char*, Link*> m_owners;	// link each buffer comes from
+
+	std::deque <Transfer*> m_pending;
+	std::deque <Transfer*> m_free;
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+
+	int m_in_flight;
+	Transfer::Type m_flight_type;
+	
+	long m_n_queued;
+	long m_n_done;
+	bool m_failed;
+
+	Timer m_request_timer;	// started when the last request went through
 
-	struct usb_device* m_fx2lp;
-	usb_dev_handle* m_handle;
+	Histogram* m_tx_latency;
+	Histogram* m_rx_latency;
+	uint64_t m_payload_begin;	// ns
 
-	struct usb_device* find_device();
-	int compute_payload(int size);
+	Transfer* acquire();
+	long push(Transfer::Type type, int request, int value, char* buffer, int length, bool last = true);
+	long pushBulk(Transfer::Type type, char* buffer, int length);
+	void pump();
+
+	static void onComplete(Transfer* transfer);
 
  public : 
-	Transceiver(const char* id);
+	Transceiver(Link* link);
 
+	// Blocking interface
 	void setData(char* data);
 
 	void rx();
@@ -44,5 +88,21 @@ class Transceiver {
 	void setRxPayload(int size);
 	void setTxPayload(int size);
 
+	// Asynchronous interface
+	char* alloc(int size);
+	void release(char* buffer, int size);
+
+	long submitTx(char* buffer, int size);
+	long submitRx(char* buffer, int size);
+	long submitIrq(int request);
+
+	bool done(long ticket);
+	void complete(long ticket);
+	void wait(long ticket, double time);
+	bool failed();
+	bool synchronous();
+
+	void observe(Histogram* tx, Histogram* rx);
+
 	~Transceiver();
-};
\ No newline at end of file
+};
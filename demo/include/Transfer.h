@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////
+// Elementary request exchanged with the FX2-LP controller
+// ---------------------------------------------------------
+// Either a vendor command on the control pipe, or a slice
+// of a bulk payload going through EP6 (out) or EP2 (in).
+// The owner is notified through the callback once the
+// request has been served (or has failed).
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+struct Transfer {
+	enum Type { CONTROL, BULK_OUT, BULK_IN };
+
+	Type type;
+	int request;	// vendor command (control only)
+	int value;		// its wValue (control only)
+
+	char* buffer;	// payload (bulk only)
+	int length;
+	bool last;		// last slice of the payload (bulk only)
+
+	int status;		// 0 when completed successfully
+	long ticket;	// position in the owner's queue
+
+	void (*callback)(Transfer* transfer);
+	void* user;
+};
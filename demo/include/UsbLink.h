@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////
+// Link to a physical FX2-LP device through libusb-1.0
+// ---------------------------------------------------------
+// Transfers are submitted with the asynchronous API, and
+// their completion is handled by a dedicated event thread.
+// When supported, the transfer buffers are allocated in
+// the kernel DMA zone to avoid the usbfs bounce copies.
+// Several boards may be plugged: they are numbered in the
+// order of the libusb device list.
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <atomic>
+
+#include <libusb.h>
+
+#include "Link.h"
+
+class UsbLink : public Link {
+ private :
+	static const int EP_OUT		= 0x06;
+	static const int EP_IN		= 0x82;
+
+	const char* m_id;
+	int m_index;
+
+	libusb_context* m_context;
+	libusb_device_handle* m_handle;
+
+	std::set <char*> m_pinned;
+
+	std::atomic <bool> m_running;
+	std::thread m_events;
+
+	static libusb_device_handle* find_device(libusb_context* context, const char* id, int index);
+	void handle_events();
+
+	static void LIBUSB_CALL complete(libusb_transfer* usb_transfer);
+
+ public :
+	UsbLink(const char* id, int index = 0);
+
+	static int count(const char* id);	// number of matching boards
+
+	int submit(Transfer* transfer);
+
+	char* alloc(int size);
+	void release(char* buffer, int size);
+
+	~UsbLink();
+};
@@ -1,65 +1,186 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <fstream>
 
 #include "include/Frame.h"
 #include "include/Canva.h"
+#include "include/FrameSource.h"
 #include "include/Interface.h"
-#include "include/Monitor.h"
+#include "include/Detector.h"
 #include "include/Timer.h"
+#include "include/Trace.h"
+#include "include/Metrics.h"
+
+#ifdef WITH_SFML
+#include "include/Monitor.h"
+#endif
 
 int main(int argc, char *argv[])
 {
 	// Constants declaration ////////////////////////////////////////////////////////
 	const int N_OUT		= 3;
-	const double DELAY	= 8.0; //5.7; // (ms)
 	const char * ARCH	= "c9-p2-c9-p2-c9-p2-c9";
 
 	const int H_SIZE	= 720;
 	const int V_SIZE	= 240;
-	const char * FOLDER	= "../data/kitti-51/";
+	// a directory of numbered images, a video (.y4m, '-' for stdin) or raw:<w>x<h>:<file>
+	std::string source_spec = "../data/kitti-51/";
+
+	const char * backend = "usb"; // usb | fake | cpu[:n_workers]
+	bool tune = false;
+
+	// headless : detections written to a file (--ndjson=<file> | --binary=<file>)
+	std::string output;
+	Detector::Format format = Detector::NDJSON;
+
+	// spans of every stage, dumped in the Chrome trace format (--trace=<file>)
+	std::string trace;
+
+	// live figures, rewritten every second in the Prometheus text format (--metrics=<file>)
+	std::string metrics_file;
+
+	for (int i = 1; i < argc; i++) {
+		std::string argument(argv[i]);
+		if (argument == "--tune")
+			tune = true;
+		else if (argument.compare(0, 9, "--ndjson=") == 0)
+			output = argument.substr(9);
+		else if (argument.compare(0, 9, "--binary=") == 0) {
+			output = argument.substr(9);
+			format = Detector::BINARY;
+		} else if (argument.compare(0, 9, "--source=") == 0)
+			source_spec = argument.substr(9);
+		else if (argument.compare(0, 10, "--metrics=") == 0)
+			metrics_file = argument.substr(10);
+		else if (argument.compare(0, 8, "--trace=") == 0) {
+			trace = argument.substr(8);
+			Trace::enable(true);
+			Trace::setThreadName("main");
+		} else
+			backend = argv[i];
+	}
+
+#ifndef WITH_SFML
+	if (output.empty())
+		output = "detections.ndjson";
+#endif
+	bool headless = !output.empty();
 	
 	// Init /////////////////////////////////////////////////////////////////////////
-	Interface CrayOn(ARCH);
-	CrayOn.setDelay(DELAY);
+	Interface CrayOn(ARCH, backend);
 	CrayOn.setLabelNb(N_OUT);
 
-	Monitor monitor(H_SIZE, V_SIZE);
-	monitor.setStride(8);
-	monitor.setZoom(2);
+	Detector detector(H_SIZE, V_SIZE);
+	detector.setStride(8);
+
+	std::ofstream detections;
+	if (headless) {
+		detections.open(output.c_str(), std::ios::binary);
+		std::cout << "# Headless, detections written to '" << output << "'\n";
+	}
+
+#ifdef WITH_SFML
+	Monitor* monitor = NULL;
+	if (!headless) {
+		monitor = new Monitor(H_SIZE, V_SIZE);
+		monitor->setStride(8);
+		monitor->setZoom(2);
+	}
+#endif
 	
 	Timer timer;
 	Canva canva;
+
+	std::atomic <long> n_frames(0);
+	Metrics* metrics = NULL;
+	if (!metrics_file.empty()) {
+		metrics = new Metrics(metrics_file);
+		metrics->summary("crayon_tile_tx_seconds", "Bus time of a tile's upload", CrayOn.latency(Interface::TX));
+		metrics->summary("crayon_tile_device_seconds", "Wait for a tile's processing, once uploaded", CrayOn.latency(Interface::DEVICE));
+		metrics->summary("crayon_tile_rx_seconds", "Bus time of a tile's results", CrayOn.latency(Interface::RX));
+		metrics->summary("crayon_tile_stitch_seconds", "Stitching time of a tile", CrayOn.latency(Interface::STITCH));
+		metrics->counter("crayon_frames_total", "Frames processed", [&n_frames] () { return (double) n_frames; });
+		metrics->rate("crayon_frames_per_second", "Frames processed per second", [&n_frames] () { return (double) n_frames; });
+#ifdef WITH_SFML
+		metrics->counter("crayon_frames_dropped_total", "Frames not displayed", 
+			[monitor] () { return monitor != NULL ? monitor->dropped() : 0; });
+#else
+		metrics->counter("crayon_frames_dropped_total", "Frames not displayed", [] () { return 0; });
+#endif
+		metrics->start();
+	}
+
+	// the frames are read ahead, in the background
+	FrameSource* source = FrameSource::open(source_spec);
+	if (source == NULL)
+		return EXIT_FAILURE;
 	
 	// Load the program and parameters //////////////////////////////////////////////
 	CrayOn.load("../coe/p_xz11.coe", 'p');
 	CrayOn.load("../coe/k_xz11.coe", 'k');
 
-	for (int k = 0; k < 1000; k++) 
+	if (tune)
+		CrayOn.tune();
+
+	for (int k = 0; ; k++) 
 	{
+#ifdef WITH_SFML
+		if (monitor != NULL && monitor->closed())
+			break;	// the window was closed
+#endif
 		// Load the input ///////////////////////////////////////////////////////////
-		std::stringstream path;
-		path << FOLDER << std::setfill('0') << std::setw(10) << k << ".png";
+		long allocations = Frame::allocations();
 
-		Frame input = canva.load(path.str());
-		canva.resize(input, 0.64);
-		canva.autoCrop(input, H_SIZE, V_SIZE);
-		
-		CrayOn.push(input);
+		Frame input = source->next();
+		if (input.width() == 0) 
+			break;	// end of the source
+
+		// resized and cropped straight into the accelerator's input
+		canva.resizeCrop(input, CrayOn.input(), 0.64, H_SIZE, V_SIZE);
+		CrayOn.push();
 
 		// FPGA based processing ////////////////////////////////////////////////////
 		timer.reset();
 		CrayOn.process();
 		std::cout << "# Input N-" << k << " processed  ";
-		std::cout << "[t = " << timer.getMillisec() << " ms]    \r" << std::flush;
+		std::cout << "[t = " << timer.getMillisec() << " ms]  ";
+		n_frames++;
 		
-		// Visualization ////////////////////////////////////////////////////////////
-		monitor.setInput(input);
-		for (int i = 1; i < N_OUT; i++)
-			monitor.pushHeatMap(CrayOn.pull(i));
-		monitor.update();
-		timer.sleep(50);
+		// Detection / Visualization ////////////////////////////////////////////////
+		if (headless) {
+			for (int i = 1; i < N_OUT; i++)
+				detector.pushHeatMap(CrayOn.pull(i));
+			detector.process();
+			detector.write(detections, k, format);
+		}
+#ifdef WITH_SFML
+		else {
+			monitor->setInput(CrayOn.input());
+			for (int i = 1; i < N_OUT; i++)
+				monitor->pushHeatMap(CrayOn.pull(i));
+			monitor->update();	// the display runs on its own thread
+		}
+#endif
+
+		// frame buffers allocated for this input (none once warmed up)
+		std::cout << "[" << Frame::allocations() - allocations << " alloc.]  ";
+#ifdef WITH_SFML
+		if (!headless)
+			std::cout << "[display : " << monitor->dropped() << " dropped, " 
+			          << monitor->latency() << " ms latency]";
+#endif
+		std::cout << "    \r" << std::flush;
 	}
+
+	delete metrics;	// last export
+	delete source;
+#ifdef WITH_SFML
+	delete monitor;
+#endif
+
+	if (!trace.empty() && Trace::dump(trace.c_str()))
+		std::cout << "\n# Trace written to '" << trace << "'\n";
 	
 	std::cout << "Work is done !" << std::endl;
     return EXIT_SUCCESS;
@@ -0,0 +1,149 @@
+#include "../include/Blur.h"
+
+#include <cmath>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+const int Blur::PASSES;
+
+Blur::Blur() {
+	for (int k = 0; k < PASSES; k++)
+		m_widths[k] = 1;
+}
+
+// Box widths of the successive passes: odd, the smaller ones
+// first, whose variances sum to the one of the Gaussian
+void Blur::configure(double deviation) {
+	double variance = deviation * deviation;
+
+	int lower = (int) std::floor(std::sqrt(12 * variance / PASSES + 1));
+	if (lower % 2 == 0) lower--;
+	lower = std::max(1, std::min(lower, MAX_WIDTH - 2));
+
+	double n_lower = (12 * variance - PASSES * lower * lower - 4 * PASSES * lower - 3 * PASSES)
+	               / (-4. * lower - 4);
+	int n_smaller = std::max(0, std::min((int) std::floor(n_lower + 0.5), PASSES));
+
+	for (int k = 0; k < PASSES; k++)
+		m_widths[k] = (k < n_smaller) ? lower : lower + 2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Each target line is the average of the 'box' source lines 
+// around it, the running sums of the columns being updated
+// from a line to the next
+void Blur::boxColumns(const BYTE* source, int stride, BYTE* target, int width, int height, int box) {
+	if (box == 1) {
+		for (int y = 0; y < height; y++)
+			std::copy(source + y * stride, source + y * stride + width, target + y * width);
+		return;
+	}
+
+	const int radius = box / 2;
+	const int half = box / 2;
+	const int inverse = (65536 + half) / box;	// 0.16 fixed point
+
+	uint16_t* sums = &m_sums[0];
+	std::fill(sums, sums + width, 0);
+
+	for (int y = 0; y < std::min(radius, height); y++) {
+		const BYTE* line = source + y * stride;
+		for (int x = 0; x < width; x++)
+			sums[x] += line[x];
+	}
+
+	for (int y = 0; y < height; y++) {
+		const BYTE* entering = (y + radius < height) ? source + (y + radius) * stride : NULL;
+		const BYTE* leaving = (y - radius >= 0) ? source + (y - radius) * stride : NULL;
+		BYTE* line = target + y * width;
+
+		int x = 0;
+#ifdef __SSE2__
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rounding = _mm_set1_epi16(half);
+		const __m128i scale = _mm_set1_epi16((short) inverse);
+
+		for (; x + 16 <= width; x += 16) {
+			__m128i low = _mm_loadu_si128((const __m128i*) &sums[x]);
+			__m128i high = _mm_loadu_si128((const __m128i*) &sums[x + 8]);
+
+			if (entering != NULL) {
+				__m128i pixels = _mm_loadu_si128((const __m128i*) &entering[x]);
+				low = _mm_add_epi16(low, _mm_unpacklo_epi8(pixels, zero));
+				high = _mm_add_epi16(high, _mm_unpackhi_epi8(pixels, zero));
+			}
+
+			__m128i average_low = _mm_mulhi_epu16(_mm_add_epi16(low, rounding), scale);
+			__m128i average_high = _mm_mulhi_epu16(_mm_add_epi16(high, rounding), scale);
+			_mm_storeu_si128((__m128i*) &line[x], _mm_packus_epi16(average_low, average_high));
+
+			if (leaving != NULL) {
+				__m128i pixels = _mm_loadu_si128((const __m128i*) &leaving[x]);
+				low = _mm_sub_epi16(low, _mm_unpacklo_epi8(pixels, zero));
+				high = _mm_sub_epi16(high, _mm_unpackhi_epi8(pixels, zero));
+			}
+
+			_mm_storeu_si128((__m128i*) &sums[x], low);
+			_mm_storeu_si128((__m128i*) &sums[x + 8], high);
+		}
+#endif
+		for (; x < width; x++) {
+			if (entering != NULL)
+				sums[x] += entering[x];
+			line[x] = ((sums[x] + half) * inverse) >> 16;
+			if (leaving != NULL)
+				sums[x] -= leaving[x];
+		}
+	}
+}
+
+// All the passes, down the columns. The passes alternate
+// between the target and a buffer, their number being odd
+// the last one ends in the target.
+void Blur::filterColumns(const BYTE* source, int stride, BYTE* target, int width, int height) {
+	BYTE* buffer = &m_buffers[1][0];
+	m_sums.resize(width);
+
+	boxColumns(source, stride, target, width, height, m_widths[0]);
+	for (int k = 1; k < PASSES; k++) {
+		std::swap(buffer, target);
+		boxColumns(buffer, width, target, width, height, m_widths[k]);
+	}
+}
+
+void Blur::transpose(const BYTE* source, int stride, BYTE* target, int width, int height) {
+	for (int y0 = 0; y0 < height; y0 += BLOCK)
+		for (int x0 = 0; x0 < width; x0 += BLOCK) {
+			int y1 = std::min(y0 + BLOCK, height);
+			int x1 = std::min(x0 + BLOCK, width);
+
+			for (int y = y0; y < y1; y++)
+				for (int x = x0; x < x1; x++)
+					target[x * height + y] = source[y * stride + x];
+		}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Blur::apply(FrameView input, Frame& output, double deviation) {
+	int width = input.width();
+	int height = input.height();
+
+	configure(deviation);
+	for (int k = 0; k < 3; k++)
+		m_buffers[k].resize(width * height);
+	output.realloc(width, height);
+
+	BYTE* columns = &m_buffers[0][0];
+	BYTE* lines = &m_buffers[2][0];
+
+	// vertically, then horizontally on the transposed frame
+	filterColumns(input.data(), input.stride(), columns, width, height);
+	transpose(columns, width, output.data(), width, height);
+	filterColumns(output.data(), height, lines, height, width);
+	transpose(lines, height, output.data(), height, width);
+}
@@ -0,0 +1,129 @@
+#include "../include/Detector.h"
+#include "../include/Trace.h"
+
+Detector::Detector(int width, int height)
+	: m_width(width), m_height(height), m_stride(1), m_n_heat_maps(0),
+	  m_peak_finder(NMS_RADIUS, THRES * 255) {}
+
+void Detector::setStride(int stride) { m_stride = stride; }
+
+// The frames of the previous process are reused
+void Detector::pushHeatMap(FrameView heat_map) {
+	if (m_n_heat_maps == m_heat_maps.size())
+		m_heat_maps.push_back(Frame(0, 0, m_canva.pool()));
+	m_heat_maps[m_n_heat_maps] = heat_map;
+	m_n_heat_maps++;
+}
+
+void Detector::process() {
+	m_heat_maps.resize(m_n_heat_maps);
+	if (m_heat_maps.size() < 2) {
+		std::cout << "# [error] At least two labels are required !\n";
+		exit(1);
+	}
+
+	refine();
+	parse();
+	detect();
+
+	m_n_heat_maps = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void Detector::refine() {
+	Span span("refine");
+
+	// rectification
+	for (int i = 0; i < m_heat_maps.size(); i++)
+		for (int x = 0; x < m_heat_maps[i].width(); x++)
+			for (int y = 0; y < m_heat_maps[i].height(); y++) {
+				int heat = m_heat_maps[i](x, y);
+				heat = std::min(255, std::max(0, (heat - 127) * 4)); // (heat - 127) * 4;
+				m_heat_maps[i](x, y) = heat;
+			}
+			
+	// washing
+	for (int i = 0; i < m_heat_maps.size(); i++)
+		m_canva.blur(m_heat_maps[i], WASHING); 
+}
+
+void Detector::parse() {
+	Span span("parse");
+	int map_width = m_heat_maps[0].width();
+	int map_height = m_heat_maps[0].height();
+
+	m_parsing.realloc(map_width, map_height);
+
+	for (int x = 0; x < map_width; x++)
+		for (int y = 0; y < map_height; y++) {
+
+			int label = 0;
+			int heat = 0;
+
+			for (int i = 0; i < m_heat_maps.size(); i++)
+				if (m_heat_maps[i](x, y) > heat) {
+					heat = m_heat_maps[i](x, y);	
+					label = i+1;
+				}
+			
+			if (heat < THRES * 256) label = 0;
+			m_parsing(x, y) = label;
+		}
+}
+
+void Detector::detect() {
+	Span span("detect");
+	m_detections.clear();
+
+	for (int i = 0; i < m_heat_maps.size(); i++) {
+		m_peak_finder.find(m_heat_maps[i], m_clusters);
+
+		for (int k = 0; k < m_clusters.size(); k++) {
+			const PeakFinder::Cluster& cluster = m_clusters[k];
+			int heat = m_heat_maps[i]((int) (cluster.x + 0.5), (int) (cluster.y + 0.5));
+
+			Detection detection;
+			detection.label = i + 1;
+			detection.x = (cluster.x + 0.5) * m_stride + anchorX();
+			detection.y = (cluster.y + 0.5) * m_stride + anchorY();
+			detection.score = heat / 255.f;
+			m_detections.push_back(detection);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+Frame& Detector::parsing() { return m_parsing; }
+
+int Detector::anchorX() { return (m_width - m_stride * m_parsing.width()) * 0.5; }
+
+int Detector::anchorY() { return (m_height - m_stride * m_parsing.height()) * 0.5; }
+
+const std::vector <Detector::Detection>& Detector::detections() { return m_detections; }
+
+void Detector::write(std::ostream& stream, int frame, Format format) {
+	if (format == BINARY) {
+		uint32_t header[2] = {(uint32_t) frame, (uint32_t) m_detections.size()};
+		stream.write((const char*) header, sizeof(header));
+
+		for (int k = 0; k < m_detections.size(); k++) {
+			const Detection& detection = m_detections[k];
+			uint32_t label = detection.label;
+			float values[3] = {detection.x, detection.y, detection.score};
+			stream.write((const char*) &label, sizeof(label));
+			stream.write((const char*) values, sizeof(values));
+		}
+	} else {
+		stream << "{\"frame\":" << frame << ",\"detections\":[";
+		for (int k = 0; k < m_detections.size(); k++) {
+			const Detection& detection = m_detections[k];
+			stream << (k ? "," : "") << "{\"label\":" << detection.label
+			       << ",\"x\":" << detection.x << ",\"y\":" << detection.y 
+			       << ",\"score\":" << detection.score << "}";
+		}
+		stream << "]}\n";
+	}
+	stream.flush();
+}
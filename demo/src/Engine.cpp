@@ -0,0 +1,366 @@
+#include "../include/Engine.h"
+#include "../include/TanhTable.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ENGINE_AVX2
+#endif
+
+const int Engine::MAP_DEPTH;
+const int Engine::ACTIV_DEPTH;
+
+Engine::Engine()
+	: m_kernels(KERNEL_DEPTH, 0), m_map_depth(0), m_activation_depth(0),
+	  m_payload(7), m_fill_mode(false), m_cyclic_order(0), m_vectorized(false) {
+
+	m_kernel_memory = &m_kernels[0];
+
+	for (int n = 0; n < VL; n++) {
+		m_biases[n] = 0;
+		std::fill(m_weights[n], m_weights[n] + D * D, 0);
+	}
+	pushKernel(KERNEL_DEPTH);	// blank supports
+
+	setVectorized(true);
+}
+
+void Engine::setVectorized(bool enabled) {
+#ifdef ENGINE_AVX2
+	m_vectorized = enabled && __builtin_cpu_supports("avx2");
+#else
+	m_vectorized = false;
+#endif
+}
+
+bool Engine::vectorized() { return m_vectorized; }
+
+// Decode the interrupt request (cf. Decoder.vhd)
+void Engine::request(int request, unsigned char* io) {
+	switch (request & 3) {
+		case 0 : propagate(io); break;
+		case 1 : loadKernels(io, (request >> 2) & 3); break;
+		case 2 : loadProgram(io); break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Engine::loadProgram(const unsigned char* io) {
+	std::vector <int> words(PROGRAM_DEPTH);
+	for (int i = 0; i < PROGRAM_DEPTH; i++)
+		words[i] = (io[2 * i] << 8) | io[2 * i + 1];
+	m_program = Program(words);
+
+	// the memories only span the slots used by the program
+	int map_depth = std::min(MAP_DEPTH, m_program.mapDepth());
+	int activation_depth = std::min(ACTIV_DEPTH, m_program.activationDepth());
+
+	if (map_depth != m_map_depth || activation_depth != m_activation_depth) {
+		m_map_depth = map_depth;
+		m_activation_depth = activation_depth;
+		for (int n = 0; n < VL; n++) {
+			m_maps[n].assign(m_map_depth, 0);
+			m_activations[n].assign(m_activation_depth, 0);
+		}
+	}
+}
+
+// 32k words chunks, of which only 12 bits are kept
+void Engine::loadKernels(const unsigned char* io, int chunk) {
+	for (int i = 0; i < 32768; i++) {
+		int address = (chunk << 15) + i;
+		if (address < KERNEL_DEPTH) {
+			int word = ((io[2 * i] << 8) | io[2 * i + 1]) & 0xFFF;
+			m_kernels[address] = (word ^ 0x800) - 0x800;
+		}
+	}
+}
+
+void Engine::shareKernels(const Engine& owner) { 
+	m_kernel_memory = &owner.m_kernels[0]; 
+}
+
+void Engine::propagate(unsigned char* io) {
+	int n_instructions = m_program.length();
+
+	for (int address = 0; address < n_instructions; address++) {
+		int operand = m_program.operand(address);
+
+		switch (m_program.opcode(address)) {
+			case Program::CONFIG :
+				m_fill_mode = (operand >> 8) & 1;
+				m_payload = (operand >> 4) & 0xF;
+				m_cyclic_order = operand & 0xF;
+				break;
+			case Program::PUSH_KERNEL :
+				pushKernel(operand & 0x3FF);
+				break;
+			case Program::CONVOLVE :
+				convolve(io, (operand >> 4) & 0xF, operand & 0xF, (operand >> 8) & 1);
+				break;
+			case Program::FIRE :
+				fire((operand >> 4) & 0xF, (operand >> 11) & 1, (operand >> 8) & 7);
+				break;
+			case Program::STORE :
+				store(io, operand & 0xFF, (operand >> 8) & 0xF);
+				break;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Keep the W lower bits, sign extended
+int Engine::wrap(int value) {
+	return (int) ((uint32_t) value << (32 - W)) >> (32 - W);
+}
+
+int Engine::activate(int value, int rect_mode) {
+	if (rect_mode == 1)
+		return value > 0 ? value : 0;
+
+	if (rect_mode == 2) {
+		int msb = (value >> (Fm - 2)) & 0x3FF;
+		int lsb = (value & ((1 << (Fm - 2)) - 1)) << (12 - Fm);
+		int result = TANH_OFFSET[msb] + ((TANH_SLOPE[msb] * lsb) >> 12);
+		return wrap(result >> (12 - Fm));
+	}
+
+	return value;
+}
+
+// The VL kernels following 'kernel_index' are shifted through the
+// NPUs: in memory, each kernel is made of its D x D weights in 
+// reverse raster order, followed by its bias.
+void Engine::pushKernel(int kernel_index) {
+	for (int n = 0; n < VL; n++) {
+		int base = (kernel_index + n) * (D * D + 1);
+
+		for (int tap = 0; tap < D * D; tap++) {
+			int address = base + D * D - 1 - tap;
+			m_weights[n][tap] = (address < KERNEL_DEPTH) ? m_kernel_memory[address] : 0;
+		}
+		int address = base + D * D;
+		m_biases[n] = (address < KERNEL_DEPTH) ? m_kernel_memory[address] : 0;
+
+		// a blank kernel has an empty support
+		Support support = {D, -1, D, -1};
+		for (int tap = 0; tap < D * D; tap++) {
+			if (m_weights[n][tap] == 0) continue;
+			support.top = std::min(support.top, tap / D);
+			support.bottom = std::max(support.bottom, tap / D);
+			support.left = std::min(support.left, tap % D);
+			support.right = std::max(support.right, tap % D);
+		}
+		m_support[n] = support;
+
+		for (int line = 0; line < D; line++)
+			for (int pair = 0; pair < (D + 1) / 2; pair++) {
+				int col = support.left + 2 * pair;
+				int low = (col < D) ? m_weights[n][line * D + col] : 0;
+				int high = (col + 1 < D) ? m_weights[n][line * D + col + 1] : 0;
+				m_pairs[n][line][pair] = (low & 0xFFFF) | (high << 16);
+			}
+	}
+}
+
+void Engine::convolve(const unsigned char* io, int input_index, int output_index, bool acc_mode) {
+	int width = Program::blockWidth(m_payload);
+	int size = Program::blockSize(m_payload);
+	int margin = (D - 1) * width + (D - 1);
+
+	// gather the routed input, preceded by zeros
+	m_source.assign(margin + size + PADDING, 0);
+	for (int k = 0; k < size; k++) {
+		int address = input_index * size + k;
+		int value = 0;
+		if (m_fill_mode) {
+			if (address < IO_DEPTH)
+				value = (int8_t) io[address] << (Fm - 7);
+		} else {
+			address &= 0x7FFF;
+			if (address < m_activation_depth)
+				value = m_activations[m_cyclic_order][address];
+		}
+		m_source[margin + k] = value;
+	}
+
+	int offset = output_index * size;
+	int count = std::min(size, m_map_depth - offset);
+	if (count <= 0) return;
+
+	int vector_end = 0;
+	if (m_vectorized) {
+		m_interleaved.resize(m_source.size() - 1);
+		for (int k = 0; k < m_interleaved.size(); k++)
+			m_interleaved[k] = (uint16_t) m_source[k] | (m_source[k + 1] << 16);
+
+		vector_end = count & ~7;
+		for (int begin = 0; begin < vector_end; begin += STRIP) {
+			int end = std::min(begin + STRIP, vector_end);
+			for (int n = 0; n < VL; n++)
+				dispatchVector(n, begin, end, width, &m_maps[n][offset], acc_mode);
+		}
+	}
+
+	for (int n = 0; n < VL; n++)
+		dispatchScalar(n, vector_end, count, width, &m_maps[n][offset], acc_mode);
+}
+
+// Columns outside the support add nothing, and lines outside
+// of it leave the (already wrapped) heap as it is.
+template <int TAPS>
+void Engine::convolveScalar(int n, int begin, int end, int width, int16_t* map, bool acc_mode) {
+	const Support& support = m_support[n];
+	const int* weights = m_weights[n];
+
+	for (int k = begin; k < end; k++) {
+		const int16_t* window = &m_source[k + support.left];
+		int heap = m_biases[n] >> (Fp - Fm);
+
+		for (int line = support.top; line <= support.bottom; line++) {
+			const int* taps = &weights[line * D + support.left];
+			const int16_t* inputs = &window[line * width];
+
+			int sum = heap << Fp;
+			for (int col = 0; col < TAPS; col++)
+				sum += taps[col] * inputs[col];
+			heap = wrap(sum >> Fp);
+		}
+
+		if (acc_mode)
+			heap = wrap(heap + map[k]);
+		map[k] = heap;
+	}
+}
+
+void Engine::dispatchScalar(int n, int begin, int end, int width, int16_t* map, bool acc_mode) {
+	switch (m_support[n].right - m_support[n].left + 1) {
+		case 1 : convolveScalar <1> (n, begin, end, width, map, acc_mode); break;
+		case 2 : convolveScalar <2> (n, begin, end, width, map, acc_mode); break;
+		case 3 : convolveScalar <3> (n, begin, end, width, map, acc_mode); break;
+		case 4 : convolveScalar <4> (n, begin, end, width, map, acc_mode); break;
+		case 5 : convolveScalar <5> (n, begin, end, width, map, acc_mode); break;
+		case 6 : convolveScalar <6> (n, begin, end, width, map, acc_mode); break;
+		case 7 : convolveScalar <7> (n, begin, end, width, map, acc_mode); break;
+		case 8 : convolveScalar <8> (n, begin, end, width, map, acc_mode); break;
+		case 9 : convolveScalar <9> (n, begin, end, width, map, acc_mode); break;
+		default : convolveScalar <0> (n, begin, end, width, map, acc_mode);
+	}
+}
+
+#ifdef ENGINE_AVX2
+
+// 8 outputs at a time, the products of two adjacent taps being
+// summed on 32 bits by 'madd'. Sums are exact, so the wrapping
+// arithmetic of the combiner lines is kept as is.
+template <int PAIRS>
+__attribute__((target("avx2")))
+void Engine::convolveVector(int n, int begin, int end, int width, int16_t* map, bool acc_mode) {
+	const Support& support = m_support[n];
+	const __m256i bias = _mm256_set1_epi32(m_biases[n] >> (Fp - Fm));
+
+	__m256i pairs[D][PAIRS > 0 ? PAIRS : 1];
+	for (int line = support.top; line <= support.bottom; line++)
+		for (int pair = 0; pair < PAIRS; pair++)
+			pairs[line][pair] = _mm256_set1_epi32(m_pairs[n][line][pair]);
+
+	for (int k = begin; k < end; k += 8) {
+		const int32_t* window = &m_interleaved[k + support.left];
+		__m256i heap = bias;
+
+		for (int line = support.top; line <= support.bottom; line++) {
+			const int32_t* inputs = &window[line * width];
+
+			__m256i sum = _mm256_slli_epi32(heap, Fp);
+			for (int pair = 0; pair < PAIRS; pair++) {
+				__m256i x = _mm256_loadu_si256((const __m256i*) &inputs[2 * pair]);
+				sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, pairs[line][pair]));
+			}
+			heap = _mm256_srai_epi32(sum, Fp);
+			heap = _mm256_srai_epi32(_mm256_slli_epi32(heap, 32 - W), 32 - W);
+		}
+
+		if (acc_mode) {
+			__m128i previous = _mm_loadu_si128((const __m128i*) &map[k]);
+			heap = _mm256_add_epi32(heap, _mm256_cvtepi16_epi32(previous));
+			heap = _mm256_srai_epi32(_mm256_slli_epi32(heap, 32 - W), 32 - W);
+		}
+
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(heap, heap), 0x08);
+		_mm_storeu_si128((__m128i*) &map[k], _mm256_castsi256_si128(packed));
+	}
+}
+
+void Engine::dispatchVector(int n, int begin, int end, int width, int16_t* map, bool acc_mode) {
+	switch ((m_support[n].right - m_support[n].left + 2) / 2) {
+		case 1 : convolveVector <1> (n, begin, end, width, map, acc_mode); break;
+		case 2 : convolveVector <2> (n, begin, end, width, map, acc_mode); break;
+		case 3 : convolveVector <3> (n, begin, end, width, map, acc_mode); break;
+		case 4 : convolveVector <4> (n, begin, end, width, map, acc_mode); break;
+		case 5 : convolveVector <5> (n, begin, end, width, map, acc_mode); break;
+		default : convolveVector <0> (n, begin, end, width, map, acc_mode);
+	}
+}
+
+#else
+
+void Engine::dispatchVector(int n, int begin, int end, int width, int16_t* map, bool acc_mode) {
+	dispatchScalar(n, begin, end, width, map, acc_mode);
+}
+
+#endif
+
+void Engine::fire(int input_index, bool pool_mode, int rect_mode) {
+	int width = Program::blockWidth(m_payload);
+	int size = Program::blockSize(m_payload);
+	int input_offset = input_index * size;
+	int output_offset = input_index * (size >> 2);
+
+	for (int n = 0; n < VL; n++) {
+		const int16_t* map = &m_maps[n][0];
+		int16_t* activation = &m_activations[n][0];
+
+		int n_outputs = pool_mode ? (size >> 2) : size;
+		for (int k = 0; k < n_outputs; k++) {
+			int output = (output_offset + k) & 0x7FFF;
+			int value;
+
+			if (pool_mode) {
+				int x = 2 * (k % (width / 2));
+				int y = 2 * (k / (width / 2));
+				int address = input_offset + y * width + x;
+				if (address + width + 1 >= m_map_depth) break;
+
+				value = activate(map[address], rect_mode);
+				value = std::max(value, activate(map[address + width], rect_mode));
+				value = std::max(value, activate(map[address + width + 1], rect_mode));
+				value = std::max(value, activate(map[address + 1], rect_mode));
+			} else {
+				if (input_offset + k >= m_map_depth) break;
+				value = activate(map[input_offset + k], rect_mode);
+			}
+
+			if (output < m_activation_depth)
+				activation[output] = value;
+		}
+	}
+}
+
+// The result buffer is the i/o buffer; the stored bytes are the 
+// bits (Fm+1 downto Fm-6) of the maps of the selected NPU.
+void Engine::store(unsigned char* io, int store_index, int store_select) {
+	int size = Program::blockSize(m_payload);
+	int offset = ((size >> 4) * store_index) << 4;
+
+	if (store_select >= VL) return;
+	const int16_t* map = &m_maps[store_select][0];
+
+	for (int k = 0; k <= size && k < m_map_depth; k++) {
+		int address = offset + k;
+		if (address < IO_DEPTH)
+			io[address] = (map[k] >> (Fm - 6)) & 0xFF;
+	}
+}
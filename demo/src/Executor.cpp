@@ -0,0 +1,243 @@
+#include "../include/Executor.h"
+#include "../include/Trace.h"
+
+Executor::Executor(int n_workers)
+	: m_generation(0), m_n_running(0), m_running(true) {
+
+	std::vector <std::vector <int> > nodes = topology();
+
+	int n_cpus = 0;
+	for (int node = 0; node < nodes.size(); node++)
+		n_cpus += nodes[node].size();
+	if (n_workers <= 0)
+		n_workers = n_cpus;
+
+	// spread the workers over the nodes
+	std::vector <Worker*> leaders(nodes.size(), (Worker*) NULL);
+	for (int k = 0; k < n_workers; k++) {
+		Worker* worker = new Worker;
+		worker->index = k;
+		worker->node = k % nodes.size();
+		
+		const std::vector <int>& cpus = nodes[worker->node];
+		worker->cpu = cpus[(k / nodes.size()) % cpus.size()];
+		
+		if (leaders[worker->node] == NULL)
+			leaders[worker->node] = worker;
+		worker->leader = leaders[worker->node];
+		worker->engine = NULL;
+		
+		m_workers.push_back(worker);
+	}
+
+	for (int k = 0; k < m_workers.size(); k++)
+		m_workers[k]->thread = std::thread(&Executor::work, this, m_workers[k]);
+
+	// the engines are allocated by their own (pinned) thread, 
+	// the leaders first since they hold the kernels
+	broadcast([] (Worker& worker) {
+		if (worker.leader == &worker) {
+			worker.engine = new Engine();
+			worker.io.assign(IO_SIZE, 0);
+		}
+	});
+	broadcast([] (Worker& worker) {
+		if (worker.leader != &worker) {
+			worker.engine = new Engine();
+			worker.engine->shareKernels(*worker.leader->engine);
+			worker.io.assign(IO_SIZE, 0);
+		}
+	});
+
+	std::cout << "# Host executor : " << m_workers.size() << " workers on " 
+	          << nodes.size() << " NUMA node(s)\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The cpus allowed to the process, per NUMA node
+std::vector <std::vector <int> > Executor::topology() {
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		for (int cpu = 0; cpu < std::thread::hardware_concurrency(); cpu++)
+			CPU_SET(cpu, &allowed);
+
+	std::vector <std::vector <int> > nodes;
+	for (int node = 0; node < 256; node++) {
+		std::stringstream path;
+		path << "/sys/devices/system/node/node" << node << "/cpulist";
+
+		std::ifstream file(path.str().c_str());
+		std::string list;
+		if (!file || !std::getline(file, list)) continue;
+
+		std::vector <int> cpus;
+		std::vector <int> listed = parseList(list);
+		for (int k = 0; k < listed.size(); k++)
+			if (listed[k] < CPU_SETSIZE && CPU_ISSET(listed[k], &allowed))
+				cpus.push_back(listed[k]);
+		if (!cpus.empty())
+			nodes.push_back(cpus);
+	}
+
+	// no NUMA information : a single node
+	if (nodes.empty()) {
+		std::vector <int> cpus;
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &allowed))
+				cpus.push_back(cpu);
+		if (cpus.empty())
+			cpus.push_back(0);
+		nodes.push_back(cpus);
+	}
+	return nodes;
+}
+
+// e.g. "0-3,8-11"
+std::vector <int> Executor::parseList(const std::string& list) {
+	std::vector <int> cpus;
+	std::stringstream strm(list);
+	std::string range;
+
+	while (std::getline(strm, range, ',')) {
+		int first, last;
+		int n_fields = sscanf(range.c_str(), "%d-%d", &first, &last);
+		if (n_fields < 1) continue;
+		if (n_fields == 1) last = first;
+		for (int cpu = first; cpu <= last; cpu++)
+			cpus.push_back(cpu);
+	}
+	return cpus;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Executor::work(Worker* worker) {
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(worker->cpu, &cpus);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+	Trace::setThreadName("worker");
+
+	long generation = 0;
+	while (true) {
+		std::function <void (Worker&)> job;
+		{
+			std::unique_lock <std::mutex> lock(m_mutex);
+			while (m_running && m_generation == generation)
+				m_start.wait(lock);
+			if (!m_running) return;
+			generation = m_generation;
+			job = m_job;
+		}
+
+		job(*worker);
+
+		std::lock_guard <std::mutex> lock(m_mutex);
+		if (--m_n_running == 0)
+			m_finish.notify_all();
+	}
+}
+
+// Run 'job' once on every worker, and wait for all of them
+void Executor::broadcast(const std::function <void (Worker&)>& job) {
+	std::unique_lock <std::mutex> lock(m_mutex);
+	m_job = job;
+	m_n_running = m_workers.size();
+	m_generation++;
+	m_start.notify_all();
+
+	while (m_n_running > 0)
+		m_finish.wait(lock);
+}
+
+// Own tiles first, then the last tiles of the other workers,
+// starting with the ones of the same node
+bool Executor::next(Worker& worker, int& tile) {
+	{
+		std::lock_guard <std::mutex> lock(worker.mutex);
+		if (!worker.tiles.empty()) {
+			tile = worker.tiles.front();
+			worker.tiles.pop_front();
+			return true;
+		}
+	}
+
+	for (int pass = 0; pass < 2; pass++)
+		for (int k = 1; k < m_workers.size(); k++) {
+			Worker& victim = *m_workers[(worker.index + k) % m_workers.size()];
+			if ((victim.node == worker.node) != (pass == 0)) continue;
+
+			std::lock_guard <std::mutex> lock(victim.mutex);
+			if (!victim.tiles.empty()) {
+				tile = victim.tiles.back();
+				victim.tiles.pop_back();
+				return true;
+			}
+		}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int Executor::size() { return m_workers.size(); }
+
+int Executor::nodes() { 
+	int n_nodes = 0;
+	for (int k = 0; k < m_workers.size(); k++)
+		n_nodes = std::max(n_nodes, m_workers[k]->node + 1);
+	return n_nodes;
+}
+
+// Every worker has its own program (and memories), while
+// the kernels are only loaded in the leaders of the nodes.
+void Executor::request(int request, const char* data) {
+	const unsigned char* io = (const unsigned char*) data;
+
+	broadcast([request, io] (Worker& worker) {
+		if ((request & 3) == 2)
+			worker.engine->loadProgram(io);
+		else if ((request & 3) == 1 && worker.leader == &worker)
+			worker.engine->loadKernels(io, (request >> 2) & 3);
+	});
+}
+
+// Each worker starts with a contiguous share of the tiles
+void Executor::run(int n_tiles, const Stage& gather, const Stage& stitch) {
+	int n_workers = m_workers.size();
+	for (int k = 0; k < n_workers; k++) {
+		Worker& worker = *m_workers[k];
+		std::lock_guard <std::mutex> lock(worker.mutex);
+		for (int tile = k * n_tiles / n_workers; tile < (k + 1) * n_tiles / n_workers; tile++)
+			worker.tiles.push_back(tile);
+	}
+
+	broadcast([this, &gather, &stitch] (Worker& worker) {
+		int tile;
+		while (next(worker, tile)) {
+			gather(tile, &worker.io[0]);
+			{
+				Span span("compute", tile);
+				worker.engine->propagate(&worker.io[0]);
+			}
+			stitch(tile, &worker.io[0]);
+		}
+	});
+}
+
+Executor::~Executor() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_running = false;
+		m_start.notify_all();
+	}
+
+	for (int k = 0; k < m_workers.size(); k++)
+		m_workers[k]->thread.join();
+
+	for (int k = 0; k < m_workers.size(); k++) {
+		delete m_workers[k]->engine;
+		delete m_workers[k];
+	}
+}
@@ -0,0 +1,109 @@
+#include "../include/FakeLink.h"
+
+FakeLink::FakeLink(Timing timing)
+	: m_running(true), m_mode(0), m_cursor(0), m_n_requests(0), m_timing(timing),
+	  m_deadline(std::chrono::steady_clock::now()), m_memory(MEMORY_SIZE, 0) {
+	m_worker = std::thread(&FakeLink::run, this);
+}
+
+int FakeLink::submit(Transfer* transfer) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	m_queue.push_back(transfer);
+	m_cond.notify_one();
+	return 0;
+}
+
+void FakeLink::run() {
+	while (true) {
+		Transfer* transfer;
+		{
+			std::unique_lock <std::mutex> lock(m_mutex);
+			while (m_running && m_queue.empty())
+				m_cond.wait(lock);
+			if (m_queue.empty())
+				return;
+			transfer = m_queue.front();
+			m_queue.pop_front();
+		}
+		serve(transfer);
+		transfer->callback(transfer);
+	}
+}
+
+// Busy for 'time' ms from the end of the previous transfer,
+// or from now if the link was idle meanwhile
+void FakeLink::spend(double time) {
+	if (time <= 0) return;
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	m_deadline = std::max(m_deadline, now) + 
+		std::chrono::duration_cast <std::chrono::steady_clock::duration> (
+			std::chrono::duration <double, std::milli> (time));
+	std::this_thread::sleep_until(m_deadline);
+}
+
+void FakeLink::serve(Transfer* transfer) {
+	transfer->status = 0;
+
+	if (transfer->type == Transfer::CONTROL) {
+		spend(m_timing.latency);
+
+		bool partial = (m_mode == 0 && m_cursor > 0 && m_cursor < MEMORY_SIZE);
+		if (partial && transfer->request != CMD_RESET) {
+			transfer->status = -1;
+			return;
+		}
+
+		switch (transfer->request) {
+			case CMD_SEND :
+				m_mode = 0;
+				m_cursor = 0;
+				break;
+			case CMD_RECEIVE :
+				m_mode = 1;
+				m_cursor = 0;
+				break;
+			case CMD_REQUEST :
+				m_n_requests++;
+				spend(m_timing.compute);
+				break;
+			case CMD_RESET :
+				m_mode = 0;
+				m_cursor = 0;
+				break;
+			default :
+				transfer->status = -1; // stall
+		}
+		return;
+	}
+
+	// a bulk transfer against the current mode would time out
+	bool out = (transfer->type == Transfer::BULK_OUT);
+	if (out != (m_mode == 0)) {
+		transfer->status = -1;
+		return;
+	}
+
+	int length = std::min(transfer->length, MEMORY_SIZE - m_cursor);
+	if (m_timing.bandwidth > 0)
+		spend(transfer->length / (m_timing.bandwidth * 1e3));
+	if (out)
+		std::memcpy(&m_memory[m_cursor], transfer->buffer, length);
+	else
+		std::memcpy(transfer->buffer, &m_memory[m_cursor], length);
+	m_cursor += length;
+}
+
+bool FakeLink::synchronous() { return true; }
+
+int FakeLink::requestCount() { return m_n_requests; }
+
+FakeLink::~FakeLink() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_running = false;
+		m_cond.notify_one();
+	}
+	if (m_worker.joinable())
+		m_worker.join();
+}
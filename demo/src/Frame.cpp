@@ -1,36 +1,104 @@
 #include "../include/Frame.h"
+#include "../include/FramePool.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::atomic <long> Frame::s_allocations(0);
 
 Frame::Frame()
-:	m_width(0), m_height(0), m_data(NULL)
+:	m_width(0), m_height(0), m_capacity(0), m_data(NULL), m_pool(NULL)
 {}
 
-Frame::Frame(int width, int height)
-	: m_width(width), m_height(height) {
-	m_data = new BYTE[m_width * m_height];
+Frame::Frame(int width, int height, FramePool* pool)
+	: m_width(width), m_height(height), m_capacity(0), m_data(NULL), m_pool(pool) {
+	reserve(m_width * m_height);
 }
 
 Frame::Frame(const Frame &frame)
-	: m_data(NULL), m_width(0), m_height(0) {
+	: m_width(0), m_height(0), m_capacity(0), m_data(NULL), m_pool(NULL) {
 	*this = frame; // overloaded '=' is used
 }
 
+Frame::Frame(Frame &&frame) noexcept
+	: m_width(frame.m_width), m_height(frame.m_height), m_capacity(frame.m_capacity),
+	  m_data(frame.m_data), m_pool(frame.m_pool) {
+	frame.m_width = frame.m_height = frame.m_capacity = 0;
+	frame.m_data = NULL;
+}
+
 Frame& Frame::operator=(const Frame &frame) {
 	if (this != &frame) {
+		realloc(frame.m_width, frame.m_height);
+		std::copy(frame.m_data, frame.m_data + m_width * m_height, m_data);
+	}
+	return *this;
+}
+
+Frame& Frame::operator=(Frame &&frame) noexcept {
+	if (m_pool != frame.m_pool)
+		return *this = (const Frame&) frame;
+
+	if (this != &frame) {
+		release();
 		m_width = frame.m_width;
 		m_height = frame.m_height;
+		m_capacity = frame.m_capacity;
+		m_data = frame.m_data;
 
-		delete [] m_data;
-		m_data = new BYTE[frame.m_width * frame.m_height];
-		std::copy(frame.m_data, frame.m_data + m_width * m_height, m_data);
+		frame.m_width = frame.m_height = frame.m_capacity = 0;
+		frame.m_data = NULL;
 	}
 	return *this;
 }
 
+Frame& Frame::operator=(FrameView view) {
+	realloc(view.width(), view.height());
+	// the view may be a window over this frame: its lines only
+	// move backwards
+	for (int y = 0; y < m_height; y++)
+		std::memmove(m_data + y * m_width, view.line(y), m_width);
+	return *this;
+}
+
 Frame::~Frame() {
-	delete [] m_data;
+	release();
+}
+
+// Make room for 'size' pixels, the content is not kept
+void Frame::reserve(int size) {
+	if (size <= m_capacity)
+		return;
+	release();
+
+	if (m_pool != NULL)
+		m_data = m_pool->acquire(size, m_capacity);
+
+	if (m_data == NULL) {
+		void* buffer = NULL;
+		if (posix_memalign(&buffer, ALIGNMENT, size) != 0) {
+			std::cout << "# [mem_error] Cannot allocate a frame buffer !\n";
+			std::exit(1);
+		}
+		m_data = (BYTE*) buffer;
+		m_capacity = size;
+		s_allocations++;
+	}
+}
+
+void Frame::release() {
+	if (m_data != NULL) {
+		if (m_pool != NULL)
+			m_pool->release(m_data, m_capacity);
+		else
+			free(m_data);
+	}
 	m_data = NULL;
+	m_capacity = 0;
 }
 
+long Frame::allocations() { return s_allocations; }
+
 BYTE& Frame::operator()(int x, int y) {
 	return m_data[m_width * y + x];
 }
@@ -41,6 +109,8 @@ int Frame::width() { return m_width; }
 
 int Frame::height() { return m_height; }
 
+FramePool* Frame::pool() { return m_pool; }
+
 /////////////////////////////////////////////////////////////////////////////////////
 
 void Frame::load(BYTE* data) {
@@ -51,13 +121,16 @@ BYTE* Frame::data() {
 	return m_data; 
 }
 
+FrameView Frame::view(int anchor_x, int anchor_y, int width, int height) {
+	return FrameView(*this).crop(anchor_x, anchor_y, width, height);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 
 Frame& Frame::realloc(int width, int height) {
 	m_width = width;
 	m_height = height;
-	delete [] m_data;
-	m_data =  new BYTE[width * height];
+	reserve(width * height);
 	return *this;  
 }
 
@@ -67,21 +140,7 @@ Frame& Frame::fill(int value) {
 }
 
 Frame& Frame::crop(int anchor_x, int anchor_y, int width, int height) {
-
-	if (anchor_x >= 0 && (anchor_x +  width) <= m_width && 
-		anchor_y >= 0 && (anchor_y + height) <= m_height) {
-		Frame output(width, height);
-
-		for (int x = 0; x < width; x++)	
-			for (int y = 0; y < height; y++)
-				output(x, y) = operator()(anchor_x + x, anchor_y + y);
-
-		*this = output;		
-	} else {
-		std::cout << "# [error] Cropping out of the input boundaries !\n";
-		std::exit(1);
-	}
-	return *this;  
+	return *this = view(anchor_x, anchor_y, width, height);
 }
 
 Frame& Frame::complement() {
@@ -0,0 +1,31 @@
+#include "../include/FramePool.h"
+
+FramePool::FramePool() {}
+
+BYTE* FramePool::acquire(int size, int& capacity) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	std::multimap <int, BYTE*>::iterator best = m_free.lower_bound(size);
+	if (best == m_free.end())
+		return NULL;
+
+	BYTE* buffer = best->second;
+	capacity = best->first;
+	m_free.erase(best);
+	return buffer;
+}
+
+void FramePool::release(BYTE* buffer, int capacity) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	m_free.insert(std::make_pair(capacity, buffer));
+}
+
+int FramePool::size() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_free.size();
+}
+
+FramePool::~FramePool() {
+	std::multimap <int, BYTE*>::iterator it;
+	for (it = m_free.begin(); it != m_free.end(); ++it)
+		free(it->second);
+}
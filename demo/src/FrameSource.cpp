@@ -0,0 +1,23 @@
+#include "../include/FrameSource.h"
+#include "../include/ImageSource.h"
+#include "../include/StreamSource.h"
+
+#include <cstdio>
+#include <iostream>
+
+FrameSource* FrameSource::open(const std::string& spec, int depth) {
+	if (spec.compare(0, 4, "raw:") == 0) {
+		int width = 0, height = 0, offset = 0;
+		if (sscanf(spec.c_str(), "raw:%dx%d:%n", &width, &height, &offset) != 2 || offset == 0 ||
+			width <= 0 || height <= 0) {
+			std::cout << "# [source_error] Expected raw:<width>x<height>:<file> !\n";
+			return NULL;
+		}
+		return StreamSource::open(spec.substr(offset), StreamSource::RAW, width, height, depth);
+	}
+
+	if (spec == "-" || (spec.size() > 4 && spec.compare(spec.size() - 4, 4, ".y4m") == 0))
+		return StreamSource::open(spec, StreamSource::Y4M, 0, 0, depth);
+
+	return ImageSource::open(spec, depth);
+}
@@ -0,0 +1,35 @@
+#include "../include/FrameView.h"
+#include "../include/Frame.h"
+
+FrameView::FrameView()
+	: m_data(NULL), m_width(0), m_height(0), m_stride(0) {}
+
+FrameView::FrameView(Frame& frame)
+	: m_data(frame.data()), m_width(frame.width()), m_height(frame.height()), 
+	  m_stride(frame.width()) {}
+
+FrameView::FrameView(BYTE* data, int width, int height, int stride)
+	: m_data(data), m_width(width), m_height(height), m_stride(stride) {}
+
+int FrameView::width() { return m_width; }
+
+int FrameView::height() { return m_height; }
+
+int FrameView::stride() { return m_stride; }
+
+BYTE& FrameView::operator()(int x, int y) {
+	return m_data[m_stride * y + x];
+}
+
+BYTE* FrameView::line(int y) { return m_data + m_stride * y; }
+
+BYTE* FrameView::data() { return m_data; }
+
+FrameView FrameView::crop(int anchor_x, int anchor_y, int width, int height) {
+	if (anchor_x < 0 || (anchor_x +  width) > m_width || 
+		anchor_y < 0 || (anchor_y + height) > m_height) {
+		std::cout << "# [error] Cropping out of the input boundaries !\n";
+		std::exit(1);
+	}
+	return FrameView(&operator()(anchor_x, anchor_y), width, height, m_stride);
+}
@@ -0,0 +1,64 @@
+#include "../include/Histogram.h"
+
+#include <algorithm>
+
+Histogram::Histogram() { reset(); }
+
+// Values below 2 * SUB_BUCKETS have their own bucket, then
+// each power of two is split into SUB_BUCKETS buckets
+int Histogram::bucket(uint64_t value) {
+	if (value < 2 * SUB_BUCKETS)
+		return value;
+
+	int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+	if (shift > MAX_BITS - SUB_BITS - 1)
+		return N_BUCKETS - 1;
+	return (shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS;
+}
+
+uint64_t Histogram::highest(int bucket) {
+	if (bucket < 2 * SUB_BUCKETS)
+		return bucket;
+
+	int shift = bucket / SUB_BUCKETS - 1;
+	uint64_t base = (uint64_t) (bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+	return base + (1ull << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+	m_counts[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Histogram::reset() {
+	for (int i = 0; i < N_BUCKETS; i++)
+		m_counts[i].store(0, std::memory_order_relaxed);
+	m_count.store(0, std::memory_order_relaxed);
+	m_sum.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::count() const { return m_count.load(std::memory_order_relaxed); }
+
+uint64_t Histogram::sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+// The upper bound of the bucket holding the value of rank
+// 'quantile', as the buckets are read while being updated
+uint64_t Histogram::percentile(double quantile) const {
+	uint64_t total = 0;
+	for (int i = 0; i < N_BUCKETS; i++)
+		total += m_counts[i].load(std::memory_order_relaxed);
+	if (total == 0)
+		return 0;
+
+	uint64_t rank = quantile * total + 0.5;
+	rank = std::max(rank, (uint64_t) 1);
+
+	uint64_t seen = 0;
+	for (int i = 0; i < N_BUCKETS; i++) {
+		seen += m_counts[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+			return highest(i);
+	}
+	return highest(N_BUCKETS - 1);
+}
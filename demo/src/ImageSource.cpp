@@ -0,0 +1,51 @@
+#include "../include/ImageSource.h"
+
+#include <dirent.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+ImageSource::ImageSource(int depth)
+	: m_loader(depth, 2), m_n_files(0), m_n_taken(0) {}
+
+ImageSource* ImageSource::open(const std::string& directory, int depth) {
+	DIR* handle = opendir(directory.c_str());
+	if (handle == NULL) {
+		std::cout << "# [source_error] Cannot open the directory '" << directory << "' !\n";
+		return NULL;
+	}
+
+	std::vector <std::string> names;
+	while (struct dirent* entry = readdir(handle)) {
+		std::string name(entry->d_name);
+		if (name.size() > 4 && name.compare(name.size() - 4, 4, ".png") == 0)
+			names.push_back(name);
+	}
+	closedir(handle);
+
+	if (names.empty()) {
+		std::cout << "# [source_error] No PNG image in '" << directory << "' !\n";
+		return NULL;
+	}
+	std::sort(names.begin(), names.end());
+
+	std::string prefix = directory;
+	if (prefix[prefix.size() - 1] != '/')
+		prefix += '/';
+
+	ImageSource* source = new ImageSource(depth);
+	for (int k = 0; k < names.size(); k++)
+		source->m_loader.enqueue(prefix + names[k]);
+	source->m_n_files = names.size();
+	return source;
+}
+
+Frame ImageSource::next() {
+	while (m_n_taken < m_n_files) {
+		Frame frame = m_loader.next();
+		m_n_taken++;
+		if (frame.width() > 0)
+			return frame;
+	}
+	return Frame();
+}
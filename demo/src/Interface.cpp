@@ -1,12 +1,34 @@
 #include "../include/Interface.h"
+#include "../include/Trace.h"
 
-void Interface::loadInputTile(int i, int j) {
-	int anchor_x = i * (m_tile_in.width() - m_overlap);
-	int anchor_y = j * (m_tile_in.height() - m_overlap);
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-	for (int x = 0; x < m_tile_in.width(); x++)
-		for (int y = 0; y < m_tile_in.height(); y++)
-			m_tile_in(x, y) = m_input(anchor_x + x, anchor_y + y);
+// Complement (XOR 0x80) a line of pixels into a transfer slot
+static void complementLine(const BYTE* source, char* target, int length) {
+	int x = 0;
+#ifdef __SSE2__
+	const __m128i sign = _mm_set1_epi8((char) 0x80);
+	for (; x + 16 <= length; x += 16) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*) (source + x));
+		_mm_storeu_si128((__m128i*) (target + x), _mm_xor_si128(pixels, sign));
+	}
+#endif
+	for (; x < length; x++)
+		target[x] = source[x] ^ 0x80;
+}
+
+// Gather the tile straight from the input frame into its slot
+// (row-major and complemented, as CrayOn expects it), so that
+// the slot is sent as is, without any intermediate copy
+void Interface::loadInputTile(int i, int j, char* slot) {
+	int width = m_tile_in.width();
+	int height = m_tile_in.height();
+
+	FrameView tile = m_input.view(i * (width - m_overlap), j * (height - m_overlap), width, height);
+	for (int y = 0; y < height; y++)
+		complementLine(tile.line(y), slot + y * width, width);
 }
 
 void Interface::updateGrid() {
@@ -20,36 +42,242 @@ void Interface::updateGrid() {
 		m_outputs[label].realloc(width, height);
 }
 
-void Interface::fillOutputTile(int i, int j, int label) {
+// The tiles only share read-only members, so that they can be
+// stitched concurrently
+void Interface::fillOutputTile(int i, int j, int label, const BYTE* tile) {
 	if (i > m_rows || j > m_cols) return;
 
-	int anchor_x = i * (m_tile_out.width() - m_spare);
-	int anchor_y = j * (m_tile_out.height() - m_spare);
+	int width = m_tile_out.width();
+	int height = m_tile_out.height();
 
-	// Last line correction (should be fixed in the FPGA design)
-	for (int x = 0; x < m_tile_out.width(); x++) {
-		int value = m_tile_out(x, m_tile_out.height() - 2);
-		m_tile_out(x, m_tile_out.height() - 1) = value;
-	}
-	
-	for (int x = 0; x < m_tile_out.width() - m_spare; x++)
-		for (int y = 0; y < m_tile_out.height() - m_spare; y++) {
-			int value = m_tile_out(m_spare + x, m_spare + y);
+	int anchor_x = i * (width - m_spare);
+	int anchor_y = j * (height - m_spare);
+
+	for (int y = 0; y < height - m_spare; y++) {
+		// Last line correction (should be fixed in the FPGA design)
+		int line = std::min(m_spare + y, height - 2);
+
+		for (int x = 0; x < width - m_spare; x++) {
+			int value = (BYTE) (tile[line * width + m_spare + x] + 128);
 			m_outputs[label](anchor_x + x, anchor_y + y) = value;
 		}
+	}
+}
+
+void Interface::gatherTile(int tile, char* slot) {
+	Span span("gather", tile);
+	loadInputTile(tile / m_cols, tile % m_cols, slot);
+}
+
+// Ticket of the request, the upload's last slice being the previous one
+long Interface::sendTile(Board* board, char* slot) {
+	Span span("tx");
+	board->transceiver.submitTx(slot, TX_PAYLOAD);
+	return board->transceiver.submitIrq(0);
+}
+
+void Interface::receiveTile(int tile, char* slot) {
+	Span span("stitch", tile);
+	uint64_t begin = Trace::now();
+
+	int data_size = m_tile_out.width() * m_tile_out.height();
+	for (int label = 0; label < m_outputs.size(); label++) {
+		BYTE* data = (BYTE*) slot + label * data_size;
+		fillOutputTile(tile / m_cols, tile % m_cols, label, data);
+	}
+	m_latencies[STITCH].record(Trace::now() - begin);
+}
+
+Interface::Board* Interface::leastLoaded() {
+	Board* best = NULL;
+	for (int k = 0; k < m_boards.size(); k++) {
+		Board* board = m_boards[k];
+		if (!board->lost && (best == NULL || board->load < best->load))
+			best = board;
+	}
+	return best;
+}
+
+// Gathering stage (thread)
+void Interface::gather() {
+	Trace::setThreadName("gatherer");
+
+	while (true) {
+		int n_tiles = m_frames.pop();
+		if (n_tiles < 0) return;
+
+		for (int tile = 0; tile < n_tiles; tile++) {
+			Board* board = leastLoaded();
+
+			// no board left: the rest of the frame is given up, and
+			// 'process()' runs it again on the fallback
+			if (board == NULL) {
+				if ((m_n_pending -= n_tiles - tile) == 0)
+					m_stitched.push(tile);
+				break;
+			}
+			board->load++;
+
+			Slot slot = {tile, board->tx_free.pop(), board};
+			gatherTile(tile, slot.buffer);
+			board->assigned.push(slot);
+		}
+	}
+}
+
+// Driving stage (thread per board). The upload of the next tile,
+// if already gathered, is queued right behind the read-back of 
+// the current one.
+void Interface::drive(Board* board) {
+	Transceiver& transceiver = board->transceiver;
+	std::ostringstream name;
+	name << "board " << (std::find(m_boards.begin(), m_boards.end(), board) - m_boards.begin());
+	Trace::setThreadName(name.str());
+
+	Slot current = board->assigned.pop();
+	if (current.buffer == NULL) return;
+	long started = sendTile(board, current.buffer);
+
+	while (true) {
+		// the device time runs from the end of the tile's upload
+		// (queued right before its request), the bus time being 
+		// recorded as the tx latency
+		transceiver.complete(started - 1);
+		{
+			Span span("device", current.tile);
+			uint64_t begin = Trace::now();
+			transceiver.wait(started, m_delay);
+			m_latencies[DEVICE].record(Trace::now() - begin);
+		}
+		board->tx_free.push(current.buffer);
+
+		Slot result = {current.tile, board->rx_free.pop(), board};
+		uint64_t rx_begin = Trace::enabled() ? Trace::now() : 0;
+		long received = transceiver.submitRx(result.buffer, RX_PAYLOAD);
+
+		bool queued = board->assigned.tryPop(current);
+		if (queued && current.buffer != NULL)
+			started = sendTile(board, current.buffer);
+
+		transceiver.complete(received);
+		if (rx_begin != 0)
+			Trace::record("rx", result.tile, rx_begin, Trace::now());
+		board->load--;
+		m_received.push(result);
+
+		if (!queued) {
+			current = board->assigned.pop();
+			if (current.buffer != NULL)
+				started = sendTile(board, current.buffer);
+		}
+		if (current.buffer == NULL) return;
+	}
+}
+
+// Stitching stage (thread)
+void Interface::stitch() {
+	Trace::setThreadName("stitcher");
+
+	while (true) {
+		Slot slot = m_received.pop();
+		if (slot.buffer == NULL) return;
+
+		receiveTile(slot.tile, slot.buffer);
+		slot.board->rx_free.push(slot.buffer);
+
+		if (--m_n_pending == 0)
+			m_stitched.push(slot.tile);
+	}
+}
+
+// "usb" (every board found), "fake:<n>", "cpu" (no board, 
+// the tiles run on the executor)
+// The fake boards can be timed like real ones : 
+// "fake:<n>:<MB/s>:<command latency (ms)>:<compute time (ms)>"
+std::vector <Link*> Interface::openLinks(const char* backend) {
+	std::string name(backend);
+	std::string kind = name.substr(0, name.find(':'));
+	int count = (kind.size() < name.size()) ? atoi(name.substr(kind.size() + 1).c_str()) : 0;
+
+	std::vector <Link*> links;
+	if (kind == "usb") {
+		int n_boards = (count > 0) ? count : std::max(1, UsbLink::count("transceiver"));
+		for (int k = 0; k < n_boards; k++)
+			links.push_back(new UsbLink("transceiver", k));
+	} else if (kind == "fake") {
+		FakeLink::Timing timing = {0, 0, 0};
+		std::istringstream options(name.substr(std::min(name.size(), kind.size() + 1)));
+		std::string field;
+		std::getline(options, field, ':');	// count
+		double* fields[3] = {&timing.bandwidth, &timing.latency, &timing.compute};
+		for (int k = 0; k < 3 && std::getline(options, field, ':'); k++)
+			*fields[k] = atof(field.c_str());
+
+		for (int k = 0; k < std::max(1, count); k++)
+			links.push_back(new FakeLink(timing));
+	} else if (kind != "cpu") {
+		std::cout << "# [init_error] Unknown backend : " << name << std::endl;
+		exit(1);
+	}
+	return links;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Interface::Interface(const char * descriptor)
-	: m_rows(0), m_cols(0),
-	  m_delay(0),	m_overlap(0), m_spare(0),
-	  m_transceiver("transceiver") {
+Interface::Board::Board(Link* link)
+	: transceiver(link), tx_free(TX_SLOTS), rx_free(RX_SLOTS), 
+	  assigned(TX_SLOTS + 1), load(0), lost(false) {
+
+	resident.program = 0;
+	resident.kernels = 0;
+
+	transceiver.setTxPayload(TX_PAYLOAD);
+	transceiver.setRxPayload(RX_PAYLOAD);
+
+	for (int k = 0; k < TX_SLOTS; k++) {
+		tx_slots[k] = transceiver.alloc(TX_PAYLOAD);
+		tx_free.push(tx_slots[k]);
+	}
+	for (int k = 0; k < RX_SLOTS; k++) {
+		rx_slots[k] = transceiver.alloc(RX_PAYLOAD);
+		rx_free.push(rx_slots[k]);
+	}
+}
+
+Interface::Board::~Board() {
+	for (int k = 0; k < TX_SLOTS; k++)
+		transceiver.release(tx_slots[k], TX_PAYLOAD);
+	for (int k = 0; k < RX_SLOTS; k++)
+		transceiver.release(rx_slots[k], RX_PAYLOAD);
+}
+
+Interface::Interface(const char * descriptor, const char * backend)
+	: m_executor(NULL), m_rows(0), m_cols(0),
+	  m_frames(1), m_received(RX_SLOTS + 1), m_stitched(1), m_n_pending(0),
+	  m_spare(0), m_overlap(0), m_delay(0), m_current(0), m_switch_time(0) {
 	  
 	m_tile_in.realloc(MEM_WIDTH, MEM_HEIGHT);
-	
-	m_transceiver.setTxPayload(TX_PAYLOAD);
-	m_transceiver.setRxPayload(RX_PAYLOAD);
+
+	m_host_resident.program = 0;
+	m_host_resident.kernels = 0;
+
+	std::vector <Link*> links = openLinks(backend);
+	for (int k = 0; k < links.size(); k++) {
+		m_boards.push_back(new Board(links[k]));
+		m_boards[k]->transceiver.observe(&m_latencies[TX], &m_latencies[RX]);
+	}
+	if (m_boards.size() > 1)
+		std::cout << "# " << m_boards.size() << " boards in use\n";
+
+	m_gatherer = std::thread(&Interface::gather, this);
+	m_stitcher = std::thread(&Interface::stitch, this);
+	for (int k = 0; k < m_boards.size(); k++)
+		m_boards[k]->driver = std::thread(&Interface::drive, this, m_boards[k]);
+
+	// "cpu" or "cpu:<n_workers>"
+	std::string name(backend);
+	if (name.compare(0, 3, "cpu") == 0)
+		m_executor = new Executor(atoi(name.substr(std::min(name.size(), (size_t) 4)).c_str()));
 
 	Frame output_init;
 	m_outputs.push_back(output_init);
@@ -57,122 +285,359 @@ Interface::Interface(const char * descriptor)
 	setArch(descriptor);
 }
 
-void Interface::push(const Frame & frame) {
+void Interface::push(FrameView frame) {
 	m_input = frame;
 	updateGrid();
 }
 
+Frame& Interface::input() { return m_input; }
+
+void Interface::push() {
+	updateGrid();
+}
+
 void Interface::process() {
-	double device_time = 0;	
-	for (int i = 0; i < m_rows; i++) {
-		for (int j = 0; j < m_cols; j++) {
-			loadInputTile(i, j);
-			m_tile_in.complement();
-			m_transceiver.setData((char *) m_tile_in.data());
-
-			m_transceiver.tx();
-			m_transceiver.irq(0);
-			m_timer.sleep(m_delay);
-			m_transceiver.rx();
-
-			int data_size = m_tile_out.width() * m_tile_out.height();
-			for (int label = 0; label < m_outputs.size(); label++) {
-				m_tile_out.load((BYTE *) m_transceiver.getData() + label * data_size);
-				m_tile_out.complement();
-				fillOutputTile(i, j, label);
-			}			
+	Span span("process");
+	int n_tiles = m_rows * m_cols;
+	if (n_tiles == 0) return;
+
+	if (m_executor != NULL) {
+		m_executor->run(n_tiles, 
+			[this] (int tile, unsigned char* io) { gatherTile(tile, (char*) io); },
+			[this] (int tile, unsigned char* io) { receiveTile(tile, (char*) io); });
+		return;
+	}
+
+	m_n_pending = n_tiles;
+	m_frames.push(n_tiles);
+	m_stitched.pop();
+
+	// the boards lost meanwhile are left out, and the frame is
+	// processed again
+	bool lost = false;
+	int n_boards = 0;
+	for (int k = 0; k < m_boards.size(); k++) {
+		Board* board = m_boards[k];
+		if (!board->lost && board->transceiver.failed()) {
+			std::cout << "# [usb_error] Board " << k << " lost !\n";
+			board->lost = true;
+			lost = true;
 		}
+		n_boards += !board->lost;
+	}
+
+	if (lost || n_boards == 0) {
+		if (n_boards == 0)
+			fallback();
+		process();
+		return;
 	}
-//	std::cout << "# device time  : " << device_time / (m_rows * m_cols)  << " (ms)" << std::endl;
 }
 
 Frame & Interface::pull(int label) { return m_outputs[label]; }
 
+Interface::~Interface() {
+	m_frames.push(-1);
+	m_gatherer.join();
+
+	for (int k = 0; k < m_boards.size(); k++) {
+		Slot stop = {-1, NULL, m_boards[k]};
+		m_boards[k]->assigned.push(stop);
+		m_boards[k]->driver.join();
+	}
+
+	Slot stop = {-1, NULL, NULL};
+	m_received.push(stop);
+	m_stitcher.join();
+
+	delete m_executor;
+
+	for (int k = 0; k < m_boards.size(); k++)
+		delete m_boards[k];
+
+	std::map <uint64_t, Entry>::iterator it;
+	for (it = m_registry.begin(); it != m_registry.end(); ++it)
+		delete it->second.model;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
+
+// 'p' : program (.coe), 'k' : kernels (.coe), 'm' : both (binary model)
+// The program or the kernels loaded from a .coe file replace the
+// ones of the current model.
 void Interface::load(const char* filename, char mode)
 {
-    std::ifstream file(filename);    
-    if (!file) {
-		std::cout << "# [load_error] failed to open '" << filename << "' !\n";
-		exit(1);  
-    }
-
-	// Parse the input file
-	std::vector <int> table;
-    std::string line, number;
-	std::string::iterator it;
-	
-    while (std::getline(file, line)) {
-		if (line[0] != ';' && line[0] != 'm') {
-			number = "";
-			it = line.begin();
-			while (*it != '\0') {
-				if (*it == ',' || *it == ';') {
-					int value;
-					sscanf(number.c_str(), "%x", &value);
-					table.push_back(value);
-					number = "";
-				} else {
-					number += *it;
-				}
-				++it;
-			}		
-		}
-	}	
-//	std::cout << "n_words : " << table.size() << "\n----\n";
-		
-	// Format it in a byte array
-	char data[2 * table.size()];
-	for(int i = 0; i < table.size(); i++) {
-		data[2 * i] = table[i] >> 8;
-		data[2 * i + 1] = table[i] & 0x00FF;
-	}
-		
-	// Push the into CrayOn
-	char buffer[TX_PAYLOAD] = {};
-	
+	if (mode == 'm') {
+		use(add(filename));
+		return;
+	}
+	if (mode != 'p' && mode != 'k') {
+		std::cout << "# [load_error] Unsupported loading mode !\n";
+		exit(1);
+	}
+
+	Model* model = new Model();
+	std::string path(filename);
+
+	std::map <uint64_t, Entry>::iterator current = m_registry.find(m_current);
+	bool loaded = (current != m_registry.end());
+
 	if (mode == 'p') {
-	
+		model->setProgram(Model::parseCoe(filename));
+		if (loaded)
+			model->copyKernels(*current->second.model);
+	} else {
+		model->setKernels(Model::parseCoe(filename));
+		if (loaded) {
+			model->copyProgram(*current->second.model);
+			path = current->second.path;
+		}
+	}
+	use(insert(model, path));
+}
+
+uint64_t Interface::add(const char* filename) {
+	Model* model = new Model();
+	model->open(filename);
+	return insert(model, filename);
+}
+
+uint64_t Interface::add(const char* program, const char* kernels) {
+	Model* model = new Model();
+	model->setProgram(Model::parseCoe(program));
+	model->setKernels(Model::parseCoe(kernels));
+	return insert(model, program);
+}
+
+// Models are registered once per content
+uint64_t Interface::insert(Model* model, const std::string& path) {
+	uint64_t key = model->hash();
+	if (m_registry.count(key)) {
+		delete model;
+		return key;
+	}
+
+	Entry entry;
+	entry.model = model;
+	entry.program = Program(model->programWords());
+	entry.path = path;
+
+	// use the device time recorded by 'tune()' if any
+	std::ifstream record((path + ".time").c_str());
+	if (!(record >> entry.delay))
+		entry.delay = entry.program.time();
+	if (model->hasProgram())
+		std::cout << "# Device time : " << entry.delay << " ms (" 
+		          << (record ? "tuned" : "predicted") << ")\n";
+
+	m_registry[key] = entry;
+	return key;
+}
+
+// Make a registered model the current one, the sections not yet
+// resident being uploaded
+void Interface::use(uint64_t key) {
+	std::map <uint64_t, Entry>::iterator it = m_registry.find(key);
+	if (it == m_registry.end()) {
+		std::cout << "# [load_error] Unknown model !\n";
+		exit(1);
+	}
+	Entry& entry = it->second;
+
+	Timer timer;
+	timer.reset();
+	int n_targets = upload(entry.model);
+	m_switch_time = timer.getMillisec();
+
+	m_current = key;
+	m_program = entry.program;
+	m_program_path = entry.path;
+	m_delay = entry.delay;
+
+	std::cout << "# Model " << std::hex << key << std::dec << " (" << entry.path << ") : ";
+	if (n_targets == 0)
+		std::cout << "already resident\n";
+	else
+		std::cout << "switched in " << m_switch_time << " ms, " << n_targets << " target(s) updated\n";
+}
+
+uint64_t Interface::current() { return m_current; }
+
+double Interface::switchTime() { return m_switch_time; }
+
+// Push the model into CrayOn, on all the boards at once.
+// Return the number of boards (and executor) updated
+int Interface::upload(Model* model) {
+	int n_programs = 0;
+	int n_kernels = 0;
+	std::vector <Board*> targets;
+
+	for (int k = 0; k <= m_boards.size(); k++) {
+		Board* board = (k < m_boards.size()) ? m_boards[k] : NULL;
+		if (board != NULL && board->lost) continue;
+		if (board == NULL && m_executor == NULL) continue;
+
+		Residency& resident = (board != NULL) ? board->resident : m_host_resident;
+		bool program = model->hasProgram() && resident.program != model->programHash();
+		bool kernels = model->hasKernels() && resident.kernels != model->kernelsHash();
+
+		n_programs += program;
+		n_kernels += kernels;
+		if (program || kernels)
+			targets.push_back(board);
+	}
+
+	if (n_programs > 0)
 		std::cout << "# Loading the µ-program memory ... \n";
-		std::copy(data, data + sizeof(data), buffer);
-		m_transceiver.setData(buffer);
-		m_transceiver.tx();
-		
-		m_transceiver.irq(2);
-		m_timer.sleep(10);
-		
-	} else if (mode == 'k') {
-	
-		int chunk_size = 65536;
-		int n_chunks = (sizeof(data) + chunk_size - 1) / chunk_size;
-//		std::cout << "n_chunks : " << n_chunks << "\n----\n";
-		std::cout << "# Loading the network's parameters ... \n";		
+	if (n_kernels > 0)
+		std::cout << "# Loading the network's parameters ... \n";
 
-		int index = 0;
+	std::vector <std::thread> loaders;
+	for (int k = 0; k < targets.size(); k++)
+		loaders.push_back(std::thread(&Interface::uploadBoard, this, targets[k], model));
+	for (int k = 0; k < loaders.size(); k++)
+		loaders[k].join();
+
+	// the latencies are the tiles' only
+	for (int stage = 0; stage < N_STAGES; stage++)
+		m_latencies[stage].reset();
+	return targets.size();
+}
+
+// Raise a load request to a board, or to the executor (NULL).
+// The FPGA only takes whole payloads: the data is sent from a 
+// transfer slot (free, the pipeline being idle), zero padded.
+void Interface::request(Board* board, const char* data, int size, int request) {
+	if (board == NULL) {
+		m_executor->request(request, data);
+		return;
+	}
+	char* slot = board->tx_slots[0];
+	std::copy(data, data + size, slot);
+	std::fill(slot + size, slot + TX_PAYLOAD, 0);
+
+	board->transceiver.complete(board->transceiver.submitTx(slot, TX_PAYLOAD));
+	board->transceiver.irq(request);
+}
+
+void Interface::uploadBoard(Board* board, Model* model) {
+	Residency& resident = (board != NULL) ? board->resident : m_host_resident;
+	Timer timer;
+
+	if (model->hasProgram() && resident.program != model->programHash()) {
+		request(board, model->program(), Model::PROGRAM_CHUNK, 2);
+		if (board != NULL) timer.sleep(10);
+		resident.program = model->programHash();
+	}
+
+	if (model->hasKernels() && resident.kernels != model->kernelsHash()) {
+		int n_chunks = model->kernelsSize() / Model::KERNELS_CHUNK;
 		for (int i = 0; i < n_chunks; i++) {
-			if (i == (n_chunks - 1)) {
-				chunk_size = sizeof(data) % chunk_size;
-				std::fill(buffer, buffer + TX_PAYLOAD, 0);
-			}
-//			std::cout << index << " -> " << (index + chunk_size - 1) << std::endl;
-			for (int j = 0; j < chunk_size; j++, index++){
-				buffer[j] = data[index];
-			}
-			m_transceiver.setData(buffer);
-			m_transceiver.tx();
-			m_transceiver.irq(1 + (i << 2));
-			m_timer.sleep(5);
+			const char* chunk = model->kernels() + i * Model::KERNELS_CHUNK;
+			request(board, chunk, Model::KERNELS_CHUNK, 1 + (i << 2));
+			if (board != NULL) timer.sleep(5);
 		}
-		
-	} else {
-		std::cout << "# [load_error] Unsupported loading mode !\n";
-		exit(1);
+		resident.kernels = model->kernelsHash();
+	}
+
+	// nothing is known of a failing board
+	if (board != NULL && board->transceiver.failed()) {
+		resident.program = 0;
+		resident.kernels = 0;
+	}
+}
+
+// Carry on with the software model, from the current model.
+// The lost boards are left out for good.
+void Interface::fallback() {
+	std::cout << "# [usb_error] No board left, falling back on the cpu engine !\n";
+	m_executor = new Executor();
+	m_host_resident.program = 0;
+	m_host_resident.kernels = 0;
+
+	std::map <uint64_t, Entry>::iterator current = m_registry.find(m_current);
+	if (current != m_registry.end())
+		upload(current->second.model);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Interface::probe(char* tile, double delay, char* result) {
+	Board* board = m_boards[0];
+	board->transceiver.submitTx(tile, TX_PAYLOAD);
+	board->transceiver.wait(board->transceiver.submitIrq(0), delay);
+	board->transceiver.complete(board->transceiver.submitRx(board->rx_slots[0], RX_PAYLOAD));
+	std::copy(board->rx_slots[0], board->rx_slots[0] + RX_PAYLOAD, result);
+}
+
+// Measure the time the loaded program actually takes on the device:
+// the results of a probe tile are read back after a decreasing delay,
+// until they differ from the ones left by a (different) flush tile.
+// The boards being identical, the first one is measured.
+double Interface::tune() {
+	if (m_executor != NULL || m_boards[0]->transceiver.synchronous()) {
+		std::cout << "# Device time : hidden by the backend, nothing to tune\n";
+		return m_delay;
 	}
+
+	char* tile = m_boards[0]->tx_slots[0];
+	char* flush = m_boards[0]->tx_slots[1];
+	for (int k = 0; k < TX_PAYLOAD; k++) {
+		tile[k] = (k % MEM_WIDTH) ^ (k / MEM_WIDTH);
+		flush[k] = ~tile[k];
+	}
+
+	std::vector <char> reference(RX_PAYLOAD);
+	std::vector <char> stale(RX_PAYLOAD);
+	std::vector <char> result(RX_PAYLOAD);
+
+	double upper = 4 * m_program.time() + 10;
+	probe(tile, upper, &reference[0]);
+	probe(flush, upper, &stale[0]);
+
+	if (reference == stale) {
+		std::cout << "# [tune_error] The probe tile is not discriminant !\n";
+		return m_delay;
+	}
+
+	double lower = 0;
+	for (int step = 0; step < 12; step++) {
+		double delay = 0.5 * (lower + upper);
+		probe(flush, 4 * m_program.time() + 10, &stale[0]);
+		probe(tile, delay, &result[0]);
+		if (result == reference)
+			upper = delay;
+		else
+			lower = delay;
+	}
+
+	for (int stage = 0; stage < N_STAGES; stage++)
+		m_latencies[stage].reset();
+
+	m_delay = 1.05 * upper; // margin for the bus jitter
+	if (m_registry.count(m_current))
+		m_registry[m_current].delay = m_delay;
+	std::cout << "# Device time : " << m_delay << " ms (tuned, predicted " 
+	          << m_program.time() << " ms)\n";
+
+	if (!m_program_path.empty()) {
+		std::ofstream record((m_program_path + ".time").c_str());
+		record << m_delay << std::endl;
+	}
+	return m_delay;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Interface::setDelay(double delay) { m_delay = delay; }
+void Interface::setDelay(double delay) { 
+	m_delay = delay; 
+	if (m_registry.count(m_current))
+		m_registry[m_current].delay = m_delay;
+}
+
+int Interface::tileCount() { return m_rows * m_cols; }
+
+const Histogram& Interface::latency(Stage stage) { return m_latencies[stage]; }
 
 void Interface::setLabelNb(int number) { 
 	if (number > 0) {
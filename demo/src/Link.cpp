@@ -0,0 +1,14 @@
+#include "../include/Link.h"
+
+char* Link::alloc(int size) {
+	void* buffer = NULL;
+	if (posix_memalign(&buffer, 64, size) != 0) {
+		std::cout << "# [mem_error] Cannot allocate a transfer buffer !\n";
+		exit(1);
+	}
+	return (char*) buffer;
+}
+
+void Link::release(char* buffer, int size) { free(buffer); }
+
+bool Link::synchronous() { return false; }
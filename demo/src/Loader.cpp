@@ -0,0 +1,94 @@
+#include "../include/Loader.h"
+#include "../include/Trace.h"
+
+#include <cstring>
+#include <png.h>
+
+Loader::Loader(int depth, int n_workers)
+	: m_depth(depth), m_n_enqueued(0), m_next(0), m_running(true) {
+
+	for (int k = 0; k < n_workers; k++)
+		m_workers.push_back(std::thread(&Loader::work, this));
+}
+
+bool Loader::decode(const std::string& filename, Frame& frame) {
+	Span span("png_load");
+	png_image image;
+	std::memset(&image, 0, sizeof(image));
+	image.version = PNG_IMAGE_VERSION;
+
+	if (!png_image_begin_read_from_file(&image, filename.c_str()))
+		return false;
+
+	image.format = PNG_FORMAT_GRAY;
+	frame.realloc(image.width, image.height);
+
+	if (!png_image_finish_read(&image, NULL, frame.data(), image.width, NULL)) {
+		png_image_free(&image);
+		frame.realloc(0, 0);
+		return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Loader::enqueue(const std::string& filename) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	Job job = {m_n_enqueued++, filename};
+	m_jobs.push_back(job);
+	m_jobs_ready.notify_one();
+}
+
+// The workers take the jobs in order, as long as they are
+// within 'depth' frames of the one to be handed over
+void Loader::work() {
+	Trace::setThreadName("loader");
+	std::unique_lock <std::mutex> lock(m_mutex);
+
+	while (true) {
+		while (m_running && (m_jobs.empty() || m_jobs.front().index >= m_next + m_depth))
+			m_jobs_ready.wait(lock);
+		if (!m_running)
+			return;
+
+		Job job = m_jobs.front();
+		m_jobs.pop_front();
+		lock.unlock();
+
+		Frame frame(0, 0, &m_pool);
+		if (!decode(job.filename, frame))
+			std::cout << "# [load_error] Cannot decode '" << job.filename << "' !\n";
+
+		lock.lock();
+		m_decoded.insert(std::make_pair(job.index, std::move(frame)));
+		m_frame_ready.notify_all();
+	}
+}
+
+Frame Loader::next() {
+	std::unique_lock <std::mutex> lock(m_mutex);
+	if (m_next >= m_n_enqueued)
+		return Frame();
+
+	std::map <int, Frame>::iterator it;
+	while ((it = m_decoded.find(m_next)) == m_decoded.end())
+		m_frame_ready.wait(lock);
+
+	Frame frame(std::move(it->second));
+	m_decoded.erase(it);
+
+	m_next++;
+	m_jobs_ready.notify_all();
+	return frame;
+}
+
+Loader::~Loader() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_running = false;
+		m_jobs_ready.notify_all();
+	}
+	for (int k = 0; k < m_workers.size(); k++)
+		m_workers[k].join();
+}
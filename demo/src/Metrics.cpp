@@ -0,0 +1,124 @@
+#include "../include/Metrics.h"
+#include "../include/Trace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+Metrics::Metrics(const std::string& filename, int period)
+	: m_filename(filename), m_period(period), m_last_export(Trace::now()), m_running(false) {}
+
+void Metrics::add(Kind kind, const std::string& name, const std::string& help, 
+	const Histogram* histogram, const std::function <double ()>& value) {
+
+	std::lock_guard <std::mutex> lock(m_mutex);
+	Metric metric = {kind, name, help, histogram, value, 0};
+	if (kind == RATE)
+		metric.last = value();
+	m_metrics.push_back(metric);
+}
+
+void Metrics::summary(const std::string& name, const std::string& help, const Histogram& histogram) {
+	add(SUMMARY, name, help, &histogram, std::function <double ()>());
+}
+
+void Metrics::counter(const std::string& name, const std::string& help, const std::function <double ()>& value) {
+	add(COUNTER, name, help, NULL, value);
+}
+
+void Metrics::gauge(const std::string& name, const std::string& help, const std::function <double ()>& value) {
+	add(GAUGE, name, help, NULL, value);
+}
+
+void Metrics::rate(const std::string& name, const std::string& help, const std::function <double ()>& counter) {
+	add(RATE, name, help, NULL, counter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Metrics::start() {
+	m_running = true;
+	m_exporter = std::thread(&Metrics::run, this);
+}
+
+void Metrics::run() {
+	Trace::setThreadName("metrics");
+
+	std::unique_lock <std::mutex> lock(m_mutex);
+	while (m_running) {
+		m_stop.wait_for(lock, std::chrono::milliseconds(m_period));
+		lock.unlock();
+		write();
+		lock.lock();
+	}
+}
+
+// Written aside, then renamed over the former export
+bool Metrics::write() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+
+	std::string temporary = m_filename + ".tmp";
+	std::ofstream file(temporary.c_str());
+	if (!file) {
+		std::cout << "# [metrics_error] Cannot write '" << temporary << "' !\n";
+		return false;
+	}
+
+	uint64_t now = Trace::now();
+	double elapsed = (now - m_last_export) / 1e9;
+	m_last_export = now;
+
+	static const double QUANTILES[3] = {0.5, 0.99, 0.999};
+	
+	for (int k = 0; k < m_metrics.size(); k++) {
+		Metric& metric = m_metrics[k];
+		file << "# HELP " << metric.name << " " << metric.help << "\n";
+
+		switch (metric.kind) {
+		case SUMMARY :
+			file << "# TYPE " << metric.name << " summary\n";
+			for (int q = 0; q < 3; q++)
+				file << metric.name << "{quantile=\"" << QUANTILES[q] << "\"} " 
+				     << metric.histogram->percentile(QUANTILES[q]) / 1e9 << "\n";
+			file << metric.name << "_sum " << metric.histogram->sum() / 1e9 << "\n";
+			file << metric.name << "_count " << metric.histogram->count() << "\n";
+			break;
+
+		case COUNTER :
+			file << "# TYPE " << metric.name << " counter\n";
+			file << metric.name << " " << metric.value() << "\n";
+			break;
+
+		case GAUGE :
+			file << "# TYPE " << metric.name << " gauge\n";
+			file << metric.name << " " << metric.value() << "\n";
+			break;
+
+		case RATE : {
+			double value = metric.value();
+			file << "# TYPE " << metric.name << " gauge\n";
+			file << metric.name << " " << (elapsed > 0 ? (value - metric.last) / elapsed : 0) << "\n";
+			metric.last = value;
+			break;
+		}
+		}
+	}
+	file.close();
+
+	if (!file || std::rename(temporary.c_str(), m_filename.c_str()) != 0) {
+		std::cout << "# [metrics_error] Cannot replace '" << m_filename << "' !\n";
+		return false;
+	}
+	return true;
+}
+
+Metrics::~Metrics() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		if (!m_running) return;
+		m_running = false;
+		m_stop.notify_all();
+	}
+	m_exporter.join();
+	write();	// final figures
+}
@@ -0,0 +1,251 @@
+#include "../include/Model.h"
+
+Model::Model()
+	: m_map(NULL), m_map_size(0), 
+	  m_program(NULL), m_program_size(0), m_program_words(0), m_program_crc(0),
+	  m_kernels(NULL), m_kernels_size(0), m_kernels_words(0), m_kernels_crc(0) {}
+
+// Map a binary model, and check it before use
+void Model::open(const char* filename) {
+	int fd = ::open(filename, O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0) {
+		std::cout << "# [load_error] failed to open '" << filename << "' !\n";
+		exit(1);
+	}
+
+	size_t size = status.st_size;
+	if (size < sizeof(Header)) {
+		std::cout << "# [load_error] '" << filename << "' is not a model !\n";
+		exit(1);
+	}
+
+	char* map = (char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		std::cout << "# [load_error] failed to map '" << filename << "' !\n";
+		exit(1);
+	}
+
+	const Header* header = (const Header*) map;
+	bool valid = !memcmp(header->magic, "CRAYON\0\0", 8) 
+		&& header->version == VERSION
+		&& header->header_size == sizeof(Header)
+		&& header->header_crc == checksum(map, offsetof(Header, header_crc))
+		&& (size_t) header->program_offset + header->program_size <= size
+		&& (size_t) header->kernels_offset + header->kernels_size <= size
+		&& header->program_size % PROGRAM_CHUNK == 0
+		&& header->kernels_size % KERNELS_CHUNK == 0
+		&& 2 * (size_t) header->program_words <= header->program_size
+		&& 2 * (size_t) header->kernels_words <= header->kernels_size;
+
+	if (!valid) {
+		std::cout << "# [load_error] '" << filename << "' is not a valid model !\n";
+		munmap(map, size);
+		exit(1);
+	}
+
+	if (checksum(map + header->program_offset, header->program_size) != header->program_crc ||
+	    checksum(map + header->kernels_offset, header->kernels_size) != header->kernels_crc) {
+		std::cout << "# [load_error] '" << filename << "' is corrupted (checksum) !\n";
+		munmap(map, size);
+		exit(1);
+	}
+
+	unmap();
+	m_map = map;
+	m_map_size = size;
+	madvise(m_map, m_map_size, MADV_WILLNEED);
+
+	m_program = m_map + header->program_offset;
+	m_program_size = header->program_size;
+	m_program_words = header->program_words;
+	m_program_crc = header->program_crc;
+
+	m_kernels = m_map + header->kernels_offset;
+	m_kernels_size = header->kernels_size;
+	m_kernels_words = header->kernels_words;
+	m_kernels_crc = header->kernels_crc;
+}
+
+void Model::save(const char* filename) {
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "CRAYON\0\0", 8);
+	header.version = VERSION;
+	header.header_size = sizeof(Header);
+
+	header.program_words = m_program_words;
+	header.program_offset = ALIGNMENT;
+	header.program_size = m_program_size;
+	header.program_crc = m_program_crc;
+
+	header.kernels_words = m_kernels_words;
+	header.kernels_offset = ALIGNMENT * ((ALIGNMENT + m_program_size + ALIGNMENT - 1) / ALIGNMENT);
+	header.kernels_size = m_kernels_size;
+	header.kernels_crc = m_kernels_crc;
+
+	header.header_crc = checksum((const char*) &header, offsetof(Header, header_crc));
+
+	std::vector <char> file(header.kernels_offset + header.kernels_size, 0);
+	memcpy(&file[0], &header, sizeof(header));
+	if (m_program_size > 0)
+		memcpy(&file[header.program_offset], m_program, m_program_size);
+	if (m_kernels_size > 0)
+		memcpy(&file[header.kernels_offset], m_kernels, m_kernels_size);
+
+	std::ofstream output(filename, std::ios::binary);
+	if (!output.write(&file[0], file.size())) {
+		std::cout << "# [save_error] failed to write '" << filename << "' !\n";
+		exit(1);
+	}
+}
+
+void Model::unmap() {
+	if (m_map != NULL)
+		munmap(m_map, m_map_size);
+	m_map = NULL;
+	m_map_size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// 16 bits words, MSB first, padded with zeros to whole chunks
+std::vector <char> Model::image(const std::vector <int>& words, int chunk) {
+	int size = 2 * words.size();
+	std::vector <char> bytes(chunk * ((size + chunk - 1) / chunk), 0);
+	for (int i = 0; i < words.size(); i++) {
+		bytes[2 * i] = words[i] >> 8;
+		bytes[2 * i + 1] = words[i] & 0x00FF;
+	}
+	return bytes;
+}
+
+void Model::setProgram(const std::vector <int>& words) {
+	m_program_image = image(words, PROGRAM_CHUNK);
+	m_program = m_program_image.empty() ? NULL : &m_program_image[0];
+	m_program_size = m_program_image.size();
+	m_program_words = words.size();
+	m_program_crc = checksum(m_program, m_program_size);
+}
+
+void Model::setKernels(const std::vector <int>& words) {
+	m_kernels_image = image(words, KERNELS_CHUNK);
+	m_kernels = m_kernels_image.empty() ? NULL : &m_kernels_image[0];
+	m_kernels_size = m_kernels_image.size();
+	m_kernels_words = words.size();
+	m_kernels_crc = checksum(m_kernels, m_kernels_size);
+}
+
+void Model::copyProgram(Model& source) {
+	m_program_image.assign(source.m_program, source.m_program + source.m_program_size);
+	m_program = m_program_image.empty() ? NULL : &m_program_image[0];
+	m_program_size = source.m_program_size;
+	m_program_words = source.m_program_words;
+	m_program_crc = source.m_program_crc;
+}
+
+void Model::copyKernels(Model& source) {
+	m_kernels_image.assign(source.m_kernels, source.m_kernels + source.m_kernels_size);
+	m_kernels = m_kernels_image.empty() ? NULL : &m_kernels_image[0];
+	m_kernels_size = source.m_kernels_size;
+	m_kernels_words = source.m_kernels_words;
+	m_kernels_crc = source.m_kernels_crc;
+}
+
+bool Model::hasProgram() { return m_program_size > 0; }
+
+bool Model::hasKernels() { return m_kernels_size > 0; }
+
+const char* Model::program() { return m_program; }
+
+int Model::programSize() { return m_program_size; }
+
+std::vector <int> Model::programWords() {
+	std::vector <int> words(m_program_words);
+	for (int i = 0; i < m_program_words; i++)
+		words[i] = ((unsigned char) m_program[2 * i] << 8) | (unsigned char) m_program[2 * i + 1];
+	return words;
+}
+
+const char* Model::kernels() { return m_kernels; }
+
+int Model::kernelsSize() { return m_kernels_size; }
+
+uint32_t Model::programHash() { return m_program_crc; }
+
+uint32_t Model::kernelsHash() { return m_kernels_crc; }
+
+uint64_t Model::hash() { return ((uint64_t) m_program_crc << 32) | m_kernels_crc; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Hexadecimal words separated by ',' or ';', the lines starting 
+// with ';' (comments) or 'm' (radix and vector keys) being skipped
+std::vector <int> Model::parseCoe(const char* filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		std::cout << "# [load_error] failed to open '" << filename << "' !\n";
+		exit(1);
+	}
+
+	file.seekg(0, std::ios::end);
+	std::vector <char> text((size_t) file.tellg());
+	file.seekg(0, std::ios::beg);
+	if (!text.empty())
+		file.read(&text[0], text.size());
+
+	std::vector <int> table;
+	table.reserve(text.size() / 5);
+
+	int value = 0;
+	bool number = false;
+	bool skipped = false;
+	bool line_start = true;
+
+	for (size_t k = 0; k < text.size(); k++) {
+		char c = text[k];
+
+		if (line_start)
+			skipped = (c == ';' || c == 'm');
+		line_start = (c == '\n');
+		if (skipped) continue;
+
+		if (c >= '0' && c <= '9') {
+			value = (value << 4) | (c - '0');
+			number = true;
+		} else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+			value = (value << 4) | ((c | 0x20) - 'a' + 10);
+			number = true;
+		} else if (c == ',' || c == ';') {
+			if (number)
+				table.push_back(value);
+			value = 0;
+			number = false;
+		}
+	}
+	return table;
+}
+
+// CRC-32 (IEEE 802.3)
+std::vector <uint32_t> Model::crcTable() {
+	std::vector <uint32_t> table(256);
+	for (uint32_t n = 0; n < 256; n++) {
+		uint32_t c = n;
+		for (int k = 0; k < 8; k++)
+			c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+		table[n] = c;
+	}
+	return table;
+}
+
+uint32_t Model::checksum(const char* data, size_t size, uint32_t crc) {
+	static const std::vector <uint32_t> table = crcTable();
+
+	crc = ~crc;
+	for (size_t k = 0; k < size; k++)
+		crc = table[(crc ^ (unsigned char) data[k]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+Model::~Model() { unmap(); }
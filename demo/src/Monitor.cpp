@@ -1,28 +1,110 @@
 #include "../include/Monitor.h"
+#include "../include/Trace.h"
 
 Monitor::Monitor(int width, int height)
-	: m_stride(1), m_zoom(1) {
-	m_window.create(sf::VideoMode(width, height), "Monitor", sf::Style::Close);
+	: m_zoom(1), m_stride(1), m_width(width), m_height(height), m_full(false), m_running(true), 
+	  m_closed(false), m_n_dropped(0), m_n_displayed(0), m_latency(0), m_detector(width, height) {
+
+	m_staging.n_heat_maps = 0;
+
+	for (int label = 0; label < PALETTE_SIZE; label++)
+		for (int value = 0; value < 256; value++) {
+			sf::Color input_color = sf::Color(value, value, value);
+			sf::Color color = blend(input_color, palette[label], RATIO);
+
+			m_blended[label][value][0] = color.r;
+			m_blended[label][value][1] = color.g;
+			m_blended[label][value][2] = color.b;
+			m_blended[label][value][3] = 255;
+		}
+
+	m_clock.reset();
+	m_renderer = std::thread(&Monitor::render, this);
 }
 
+// Post the frame, dropping the one the display did not take
 void Monitor::update() {
+	m_staging.stride = m_stride;
+	m_staging.zoom = m_zoom;
+	m_staging.time = m_clock.getMillisec();
+
+	std::lock_guard <std::mutex> lock(m_mutex);
+	if (m_full)
+		m_n_dropped++;
+	std::swap(m_staging, m_mailbox);
+	m_full = true;
+	m_staging.n_heat_maps = 0;
+	m_posted.notify_one();
+}
 
-	if (m_heat_maps.size() < 2) {
-		std::cout << "# [error] At least two labels are required !\n";
-		exit(1);
-	}
+// The display loop, the window belonging to this thread
+void Monitor::render() {
+	Timer clock = m_clock;	// same origin, own state
+	Trace::setThreadName("render");
+	m_window.create(sf::VideoMode(m_width, m_height), "Monitor", sf::Style::Close);
+
+	while (true) {
+		bool closing = false;
+		sf::Event event;
+		while (m_window.pollEvent(event))
+			closing |= (event.type == sf::Event::Closed);
+
+		{
+			std::unique_lock <std::mutex> lock(m_mutex);
+			if (closing) {
+				m_closed = true;	// the main loop winds down
+				break;
+			}
+			while (m_running && !m_full)
+				m_posted.wait_for(lock, std::chrono::milliseconds(50));	// keep polling the events
+			if (!m_running)
+				break;
+			std::swap(m_shown, m_mailbox);
+			m_full = false;
+		}
+
+		m_input = m_shown.input;
+		m_detector.setStride(m_shown.stride);
+		for (int i = 0; i < m_shown.n_heat_maps; i++)
+			m_detector.pushHeatMap(m_shown.heat_maps[i]);
+
+		m_detector.process();
+		{
+			Span span("render");
+			process();
+			m_window.display();
+		}
 
-	sf::Event event;
-	while (m_window.pollEvent(event)) {
-	    if (event.type == sf::Event::Closed)
-			exit(0);
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_latency += clock.getMillisec() - m_shown.time;
+		m_n_displayed++;
 	}
-			
-	refine();	
-	process();
 
-	m_heat_maps.clear();
-	m_window.display();
+	m_window.close();
+}
+
+int Monitor::dropped() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_n_dropped;
+}
+
+double Monitor::latency() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_n_displayed ? m_latency / m_n_displayed : 0;
+}
+
+bool Monitor::closed() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_closed;
+}
+
+Monitor::~Monitor() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_running = false;
+		m_posted.notify_one();
+	}
+	m_renderer.join();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -36,139 +118,81 @@ sf::Color Monitor::blend(sf::Color a, sf::Color b, double ratio) {
 	return m;
 }
 
-void Monitor::refine() {
-
-	// rectification
-	for (int i = 0; i < m_heat_maps.size(); i++)
-		for (int x = 0; x < m_heat_maps[i].width(); x++)
-			for (int y = 0; y < m_heat_maps[i].height(); y++) {
-				int heat = m_heat_maps[i](x, y);
-				heat = std::min(255, std::max(0, (heat - 127) * 4)); // (heat - 127) * 4;
-				m_heat_maps[i](x, y) = heat;
-			}
-			
-	// washing
-	for (int i = 0; i < m_heat_maps.size(); i++)
-		m_canva.blur(m_heat_maps[i], WASHING); 
-}
-
 void Monitor::process() {
 
 	int width = m_input.width();
 	int height = m_input.height();
 
-	int map_width = m_heat_maps[0].width();
-	int map_height = m_heat_maps[0].height();
+	Frame& labels = m_detector.parsing();
+	int map_width = labels.width();
+	int map_height = labels.height();
 
-	int anchor_x = (width  - m_stride *  map_width) * 0.5;
-	int anchor_y = (height - m_stride * map_height) * 0.5;
-	
-	// parsing	
-	m_parsing.realloc(width, height).fill(0);
-
-	for (int x = 0; x < map_width; x++)
-		for (int y = 0; y < map_height; y++) {
-
-			int label = 0;
-			int heat = 0;
-
-			for (int i = 0; i < m_heat_maps.size(); i++)
-				if (m_heat_maps[i](x, y) > heat) {
-					heat = m_heat_maps[i](x, y);	
-					label = i+1;
-				}
-			
-			if (heat < THRES * 256) label = 0;
-
-			for (int dx = 0; dx < m_stride; dx++)	
-				for (int dy = 0; dy < m_stride; dy++) {
-					int pos_x = anchor_x + m_stride * x + dx;
-					int pos_y = anchor_y + m_stride * y + dy;
-					m_parsing(pos_x, pos_y) = label;
-				}
-		}
-		
-	// blending
-	m_screen_image.create(width, height);
+	int anchor_x = m_detector.anchorX();
+	int anchor_y = m_detector.anchorY();
 
-	for (int x = 0; x < width; x++)
-		for (int y = 0; y < height; y++) {
-			int value = m_input(x, y);
-			sf::Color input_color = sf::Color(value, value, value);
-			sf::Color label_color = palette[m_parsing(x, y)];
+	// (re)size the screen buffers
+	if (m_screen_texture.getSize() != sf::Vector2u(width, height)) {
+		m_screen_texture.create(width, height);
+		m_screen_sprite.setTexture(m_screen_texture, true);
+		m_pixels.resize(4 * width * height);
+	}
 
-			sf::Color blended = blend(input_color, label_color, RATIO);
-			m_screen_image.setPixel(x, y, blended);
+	m_map_columns.resize(width);
+	for (int x = 0; x < width; x++) {
+		int column = (x - anchor_x) / m_shown.stride;
+		bool inside = x >= anchor_x && column < map_width;
+		m_map_columns[x] = inside ? column : -1;
+	}
+	
+	// blending of the parsing, line by line
+	for (int y = 0; y < height; y++) {
+		int line = (y - anchor_y) / m_shown.stride;
+		bool inside = y >= anchor_y && line < map_height;
+
+		const BYTE* input = &m_input(0, y);
+		const BYTE* parsing = inside ? &labels(0, line) : NULL;
+		sf::Uint8* pixel = &m_pixels[4 * width * y];
+
+		for (int x = 0; x < width; x++, pixel += 4) {
+			int column = m_map_columns[x];
+			int label = (parsing != NULL && column >= 0) ? parsing[column] : 0;
+			const sf::Uint8* color = m_blended[label][input[x]];
+
+			pixel[0] = color[0];
+			pixel[1] = color[1];
+			pixel[2] = color[2];
+			pixel[3] = color[3];
 		}
+	}
 
 	// rendering
-	m_screen_texture.loadFromImage(m_screen_image);
-	m_screen_sprite.setTexture(m_screen_texture, true);
+	m_screen_texture.update(&m_pixels[0]);
 
-	m_window.setSize(sf::Vector2u(m_zoom * width, m_zoom * height));
+	m_window.setSize(sf::Vector2u(m_shown.zoom * width, m_shown.zoom * height));
 	m_window.draw(m_screen_sprite);
 	
 	// detection
-	for (size_t label = 0; label < m_heat_maps.size(); label++) {
-
-		int nms_rad = 3;
-		std::vector <sf::Vector2i> peaks;
-		for (int x = 0; x < map_width - 2 * nms_rad; x++)
-			for (int y = 0; y < map_height - 2 * nms_rad; y++) {
-		
-				bool is_peak = true;
-				int value = m_heat_maps[label](x + nms_rad, y + nms_rad);
-			
-				for(int dx = 0; dx < (2 * nms_rad + 1); dx++)
-					for(int dy = 0; dy < (2 * nms_rad + 1); dy++)
-						if (value < m_heat_maps[label](x + dx, y + dy))
-							is_peak = false;
-
-				if (is_peak && value > (THRES * 255))
-					peaks.push_back(sf::Vector2i(x + nms_rad, y + nms_rad));
-			}
-		
-		std::vector <int> counts;
-		std::vector <sf::Vector2f> clusters;
-		for (int i = 0; i< peaks.size(); i++)
-		{
-			int j = 0;
-			bool merged = false;
-			while (j < clusters.size() && !merged) {
-				int dx = std::abs(clusters[j].x - peaks[i].x);
-				int dy = std::abs(clusters[j].y - peaks[i].y);
-				if (dx < nms_rad && dy < nms_rad) {
-					int n = counts[j];
-					clusters[j].x = (clusters[j].x * n + peaks[i].x) / (n + 1);
-					clusters[j].y = (clusters[j].y * n + peaks[i].y) / (n + 1);
-					counts[j]++;
-					merged = true;
-				}
-				j++;
-			}	
-			if (!merged) { 
-				clusters.push_back((sf::Vector2f) peaks[i]);
-				counts.push_back(0);
-			}
-		}
-		
-		Target target(palette[label+1], 16);
-
-		for (size_t i = 0; i < clusters.size(); i++) {
-			int x = (clusters[i].x + 0.5) * m_stride + anchor_x;
-			int y = (clusters[i].y + 0.5) * m_stride + anchor_y;
-			target.setPosition(x, y);
-			target.draw(m_window);
-		}
+	const std::vector <Detector::Detection>& detections = m_detector.detections();
+	for (size_t i = 0; i < detections.size(); i++) {
+		Target target(palette[detections[i].label], 16);
+		target.setPosition(detections[i].x, detections[i].y);
+		target.draw(m_window);
 	}
 }
 
 //////////////////////////////////////////////////////////////////////
 
+// For the next posts, the display only reads the posted one
 void Monitor::setStride(int stride) { m_stride = stride; }
 
-void Monitor::setInput(Frame& input) { m_input = input; }
+void Monitor::setInput(FrameView input) { m_staging.input = input; }
 
-void Monitor::pushHeatMap(Frame& heat_map) { m_heat_maps.push_back(heat_map); }
+// The frames of the previous posts are reused
+void Monitor::pushHeatMap(FrameView heat_map) {
+	std::vector <Frame>& heat_maps = m_staging.heat_maps;
+	if (m_staging.n_heat_maps == heat_maps.size())
+		heat_maps.push_back(Frame());
+	heat_maps[m_staging.n_heat_maps++] = heat_map;
+}
 
 void Monitor::setZoom(int zoom) { m_zoom = zoom; }
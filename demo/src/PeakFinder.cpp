@@ -0,0 +1,121 @@
+#include "../include/PeakFinder.h"
+
+#include <cmath>
+#include <algorithm>
+
+PeakFinder::PeakFinder(int radius, double threshold)
+	: m_radius(radius), m_threshold(threshold), m_grid_width(0) {}
+
+void PeakFinder::setRadius(int radius) { m_radius = radius; }
+
+void PeakFinder::setThreshold(double threshold) { m_threshold = threshold; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Maxima of the 'length - 2r' complete windows along a line:
+// a window spans at most two blocks of 2r+1 samples, and its
+// maximum is the one of the suffix of the first block and of
+// the prefix of the second
+void PeakFinder::runningMax(const BYTE* input, int step, int length, BYTE* output, int output_step) {
+	int size = 2 * m_radius + 1;
+	BYTE* prefix = &m_prefix[0];
+	BYTE* suffix = &m_suffix[0];
+
+	for (int begin = 0; begin < length; begin += size) {
+		int end = std::min(begin + size, length);
+
+		prefix[begin] = input[begin * step];
+		for (int k = begin + 1; k < end; k++)
+			prefix[k] = std::max(prefix[k - 1], input[k * step]);
+
+		suffix[end - 1] = input[(end - 1) * step];
+		for (int k = end - 2; k >= begin; k--)
+			suffix[k] = std::max(suffix[k + 1], input[k * step]);
+	}
+
+	for (int k = 0; k + size <= length; k++)
+		output[k * output_step] = std::max(suffix[k], prefix[k + size - 1]);
+}
+
+int PeakFinder::cell(float x, float y) {
+	return (int) (y / m_radius) * m_grid_width + (int) (x / m_radius);
+}
+
+// The clusters of the 3 x 3 cells around the peak are the 
+// only ones closer than r, the first of them is picked
+void PeakFinder::merge(int x, int y, std::vector <Cluster>& clusters) {
+	int column = x / m_radius;
+	int line = y / m_radius;
+	int grid_height = m_cells.size() / m_grid_width;
+	int best = -1;
+
+	for (int j = std::max(0, line - 1); j <= std::min(line + 1, grid_height - 1); j++)
+		for (int i = std::max(0, column - 1); i <= std::min(column + 1, m_grid_width - 1); i++) {
+			const std::vector <int>& members = m_cells[j * m_grid_width + i];
+			for (int k = 0; k < members.size(); k++) {
+				const Cluster& cluster = clusters[members[k]];
+				if (std::abs(cluster.x - x) < m_radius && std::abs(cluster.y - y) < m_radius &&
+					(best < 0 || members[k] < best))
+					best = members[k];
+			}
+		}
+
+	if (best < 0) {
+		Cluster cluster = {(float) x, (float) y, 0};
+		m_cells[cell(x, y)].push_back(clusters.size());
+		clusters.push_back(cluster);
+		return;
+	}
+
+	Cluster& cluster = clusters[best];
+	int previous = cell(cluster.x, cluster.y);
+	int n = cluster.count;
+	cluster.x = (cluster.x * n + x) / (n + 1);
+	cluster.y = (cluster.y * n + y) / (n + 1);
+	cluster.count++;
+
+	int current = cell(cluster.x, cluster.y);
+	if (current != previous) {
+		std::vector <int>& members = m_cells[previous];
+		members.erase(std::find(members.begin(), members.end(), best));
+		m_cells[current].push_back(best);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The peaks are merged in column-major order
+void PeakFinder::find(FrameView map, std::vector <Cluster>& clusters) {
+	clusters.clear();
+
+	int width = map.width();
+	int height = map.height();
+	int size = 2 * m_radius + 1;
+	if (width < size || height < size)
+		return;
+
+	// maxima along the lines, then along the columns
+	int n_windows_x = width - size + 1;
+	int n_windows_y = height - size + 1;
+
+	m_prefix.resize(std::max(width, height));
+	m_suffix.resize(std::max(width, height));
+	m_maxima.resize(n_windows_x * height);
+
+	for (int y = 0; y < height; y++)
+		runningMax(map.line(y), 1, width, &m_maxima[y * n_windows_x], 1);
+	for (int x = 0; x < n_windows_x; x++)
+		runningMax(&m_maxima[x], n_windows_x, height, &m_maxima[x], n_windows_x);
+
+	m_grid_width = width / m_radius + 1;
+	m_cells.resize(m_grid_width * (height / m_radius + 1));
+	for (int k = 0; k < m_cells.size(); k++)
+		m_cells[k].clear();
+
+	for (int x = 0; x < n_windows_x; x++)
+		for (int y = 0; y < n_windows_y; y++) {
+			int value = map(x + m_radius, y + m_radius);
+			if (value == m_maxima[y * n_windows_x + x] && value > m_threshold)
+				merge(x + m_radius, y + m_radius, clusters);
+		}
+}
@@ -0,0 +1,120 @@
+#include "../include/Program.h"
+
+Program::Program() {}
+
+Program::Program(const std::vector <int>& words) : m_words(words) {}
+
+int Program::size() { return m_words.size(); }
+
+int Program::opcode(int address) { return (m_words[address] >> 12) & 0xF; }
+
+int Program::operand(int address) { return m_words[address] & 0xFFF; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// 20 * 16 = 320
+int Program::blockWidth(int payload) { return 20 << (payload - 3); }
+
+// 300 * 256 = 76800
+int Program::blockSize(int payload) { return 300 << (2 * payload - 6); }
+
+// Number of instructions before the first jump (i.e. one pass)
+int Program::length() {
+	int address = 0;
+	while (address < size() && opcode(address) != JUMP)
+		address++;
+	return address;
+}
+
+// fetch, decode and call take 3 cycles, then the hold state 
+// lasts 2 cycles more than its release count.
+long Program::cycles(int address, int payload) {
+	switch (opcode(address)) {
+		case JUMP :			return 5;
+		case CONFIG :		return 5 + TAU;
+		case PUSH_KERNEL :	return 5 + VL * (D + 1) * D;
+		default :			return 5 + TAU + blockSize(payload);
+	}
+}
+
+// An interrupt only restarts the program once the running 
+// instruction is over, so the longest one is accounted for.
+long Program::cycles() {
+	long total = 0;
+	long longest = 0;
+	int payload = 7;
+	int n_instructions = length();
+
+	for (int address = 0; address < n_instructions; address++) {
+		if (opcode(address) == CONFIG)
+			payload = (operand(address) >> 4) & 0xF;
+		long count = cycles(address, payload);
+		longest = std::max(longest, count);
+		total += count;
+	}
+	return total + longest;
+}
+
+// in milliseconds
+double Program::time() { return 1e3 * cycles() / CLOCK; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Maps words up to the end of the highest slot addressed by one
+// pass, the stores reading the first block (plus one word).
+int Program::mapDepth() {
+	int depth = 0;
+	int payload = 7;
+	int n_instructions = length();
+
+	for (int address = 0; address < n_instructions; address++) {
+		int value = operand(address);
+		int size = blockSize(payload);
+
+		switch (opcode(address)) {
+			case CONFIG :
+				payload = (value >> 4) & 0xF;
+				break;
+			case CONVOLVE :
+				depth = std::max(depth, ((value & 0xF) + 1) * size);
+				break;
+			case FIRE :
+				depth = std::max(depth, (((value >> 4) & 0xF) + 1) * size);
+				break;
+			case STORE :
+				depth = std::max(depth, size + 1);
+				break;
+		}
+	}
+	return depth;
+}
+
+// Same for the activations, whose addresses wrap on 15 bits
+int Program::activationDepth() {
+	int depth = 0;
+	int payload = 7;
+	bool fill_mode = false;
+	int n_instructions = length();
+
+	for (int address = 0; address < n_instructions; address++) {
+		int value = operand(address);
+		int size = blockSize(payload);
+		int index = (value >> 4) & 0xF;
+		int pooled = ((value >> 11) & 1) ? (size >> 2) : size;
+
+		switch (opcode(address)) {
+			case CONFIG :
+				payload = (value >> 4) & 0xF;
+				fill_mode = (value >> 8) & 1;
+				break;
+			case CONVOLVE :
+				if (!fill_mode)
+					depth = std::max(depth, std::min((index + 1) * size, 0x8000));
+				break;
+			case FIRE :
+				depth = std::max(depth, std::min(index * (size >> 2) + pooled, 0x8000));
+				break;
+		}
+	}
+	return depth;
+}
@@ -0,0 +1,238 @@
+#include "../include/Resampler.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RESAMPLER_AVX2
+#endif
+
+Resampler::Resampler()
+	: m_width(0), m_height(0), m_scale(0), m_out_width(0), m_out_height(0),
+	  m_first_column(0), m_vectorized(false) {
+
+	setVectorized(true);
+}
+
+void Resampler::setVectorized(bool enabled) {
+#ifdef RESAMPLER_AVX2
+	m_vectorized = enabled && __builtin_cpu_supports("avx2");
+#else
+	m_vectorized = false;
+#endif
+}
+
+bool Resampler::vectorized() { return m_vectorized; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Resampler::Axis::bilinear(int n_inputs, int offset, int n_outputs, double scale) {
+	taps = 2;
+	index.resize(taps * n_outputs);
+	weight.resize(taps * n_outputs);
+
+	for (int i = 0; i < n_outputs; i++) {
+		double position = (offset + i + 0.5) / scale - 0.5;
+		position = std::max(0., std::min(position, n_inputs - 1.));
+
+		int first = (int) position;
+		int fraction = (int) std::floor(256 * (position - first) + 0.5);
+
+		index[2 * i] = first;
+		index[2 * i + 1] = std::min(first + 1, n_inputs - 1);
+		weight[2 * i] = 256 - fraction;
+		weight[2 * i + 1] = fraction;
+	}
+}
+
+// The weights are rounded on their running sum, which makes
+// them sum to 256 exactly
+void Resampler::Axis::area(int n_inputs, int offset, int n_outputs, double scale) {
+	taps = (int) std::ceil(1 / scale) + 1;
+	index.assign(taps * n_outputs, 0);
+	weight.assign(taps * n_outputs, 0);
+
+	for (int i = 0; i < n_outputs; i++) {
+		double begin = (offset + i) / scale;
+		double end = std::min((offset + i + 1) / scale, (double) n_inputs);
+
+		double covered = 0;
+		int rounded = 0;
+		int first = (int) begin;
+
+		for (int t = 0; t < taps; t++) {
+			int k = std::min(first + t, n_inputs - 1);
+			double overlap = std::min(end, k + 1.) - std::max(begin, (double) k);
+			if (first + t < n_inputs && overlap > 0)
+				covered += overlap / (end - begin);
+
+			int total = (int) std::floor(256 * covered + 0.5);
+			index[taps * i + t] = k;
+			weight[taps * i + t] = total - rounded;
+			rounded = total;
+		}
+	}
+}
+
+// The tables only cover the 'out_width' x 'out_height' window
+// centered in the resized frame
+void Resampler::configure(int width, int height, double scale, int out_width, int out_height) {
+	if (width == m_width && height == m_height && scale == m_scale &&
+		out_width == m_out_width && out_height == m_out_height)
+		return;
+
+	int offset_x = 0.5 * (std::floor(scale * width) - out_width);
+	int offset_y = 0.5 * (std::floor(scale * height) - out_height);
+
+	if (offset_x < 0 || offset_y < 0) {
+		std::cout << "# [error] Cropping out of the input boundaries !\n";
+		std::exit(1);
+	}
+
+	if (scale < 1) {
+		m_columns.area(width, offset_x, out_width, scale);
+		m_lines.area(height, offset_y, out_height, scale);
+	} else {
+		m_columns.bilinear(width, offset_x, out_width, scale);
+		m_lines.bilinear(height, offset_y, out_height, scale);
+	}
+
+	// only the input columns in use are blended, from 'm_first_column'
+	m_first_column = *std::min_element(m_columns.index.begin(), m_columns.index.end());
+	int last_column = *std::max_element(m_columns.index.begin(), m_columns.index.end());
+	for (int k = 0; k < m_columns.index.size(); k++)
+		m_columns.index[k] -= m_first_column;
+
+	m_width = width;
+	m_height = height;
+	m_scale = scale;
+	m_out_width = out_width;
+	m_out_height = out_height;
+	m_blended.resize(last_column - m_first_column + 1);
+	m_sources.resize(m_lines.taps);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// The products of 8-bit pixels by weights summing to 256 are
+// summed exactly on 16 bits
+void Resampler::blendScalar(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target) {
+	for (; x < width; x++) {
+		int sum = 128;
+		for (int t = 0; t < taps; t++)
+			sum += weights[t] * lines[t][x];
+		target[x] = sum >> 8;
+	}
+}
+
+void Resampler::blendVector(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target) {
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i half = _mm_set1_epi16(128);
+
+	for (; x + 16 <= width; x += 16) {
+		__m128i low = half;
+		__m128i high = half;
+		for (int t = 0; t < taps; t++) {
+			__m128i weight = _mm_set1_epi16(weights[t]);
+			__m128i pixels = _mm_loadu_si128((const __m128i*) &lines[t][x]);
+			low = _mm_add_epi16(low, _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), weight));
+			high = _mm_add_epi16(high, _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), weight));
+		}
+		low = _mm_srli_epi16(low, 8);
+		high = _mm_srli_epi16(high, 8);
+		_mm_storeu_si128((__m128i*) &target[x], _mm_packus_epi16(low, high));
+	}
+#endif
+	blendScalar(lines, weights, taps, x, width, target);
+}
+
+#ifdef RESAMPLER_AVX2
+
+__attribute__((target("avx2")))
+void Resampler::blendWide(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target) {
+	const __m256i half = _mm256_set1_epi16(128);
+
+	for (; x + 32 <= width; x += 32) {
+		__m256i low = half;
+		__m256i high = half;
+		for (int t = 0; t < taps; t++) {
+			__m256i weight = _mm256_set1_epi16(weights[t]);
+			__m128i first = _mm_loadu_si128((const __m128i*) &lines[t][x]);
+			__m128i second = _mm_loadu_si128((const __m128i*) &lines[t][x + 16]);
+			low = _mm256_add_epi16(low, _mm256_mullo_epi16(_mm256_cvtepu8_epi16(first), weight));
+			high = _mm256_add_epi16(high, _mm256_mullo_epi16(_mm256_cvtepu8_epi16(second), weight));
+		}
+		low = _mm256_srli_epi16(low, 8);
+		high = _mm256_srli_epi16(high, 8);
+
+		// 'packus' works within the 128-bit lanes
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xd8);
+		_mm256_storeu_si256((__m256i*) &target[x], packed);
+	}
+	blendVector(lines, weights, taps, x, width, target);
+}
+
+#else
+
+void Resampler::blendWide(BYTE** lines, const uint16_t* weights, int taps, int x, int width, BYTE* target) {
+	blendVector(lines, weights, taps, x, width, target);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+// TAPS = 0 for any number of taps
+template <int TAPS>
+void Resampler::resampleLine(const BYTE* blended, int width, BYTE* target) {
+	const int taps = TAPS > 0 ? TAPS : m_columns.taps;
+	const int* index = &m_columns.index[0];
+	const uint16_t* weight = &m_columns.weight[0];
+
+	for (int x = 0; x < width; x++, index += taps, weight += taps) {
+		int sum = 128;
+		for (int t = 0; t < taps; t++)
+			sum += weight[t] * blended[index[t]];
+		target[x] = sum >> 8;
+	}
+}
+
+void Resampler::resize(FrameView input, Frame& output, double scale) {
+	int width = std::floor(scale * input.width());
+	int height = std::floor(scale * input.height());
+	resize(input, output, scale, width, height);
+}
+
+void Resampler::resize(FrameView input, Frame& output, double scale, int width, int height) {
+	configure(input.width(), input.height(), scale, width, height);
+	output.realloc(width, height);
+
+	int x_taps = m_columns.taps;
+	int y_taps = m_lines.taps;
+	int n_blended = m_blended.size();
+	BYTE** lines = &m_sources[0];
+	BYTE* blended = &m_blended[0];
+
+	for (int y = 0; y < height; y++) {
+		// blend the input lines
+		for (int t = 0; t < y_taps; t++)
+			lines[t] = input.line(m_lines.index[y * y_taps + t]) + m_first_column;
+
+		const uint16_t* weights = &m_lines.weight[y * y_taps];
+		if (m_vectorized)
+			blendWide(lines, weights, y_taps, 0, n_blended, blended);
+		else
+			blendVector(lines, weights, y_taps, 0, n_blended, blended);
+
+		// then its columns
+		BYTE* target = &output(0, y);
+		switch (x_taps) {
+			case 2 : resampleLine <2> (blended, width, target); break;
+			case 3 : resampleLine <3> (blended, width, target); break;
+			case 4 : resampleLine <4> (blended, width, target); break;
+			default : resampleLine <0> (blended, width, target);
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#include "../include/StreamSource.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+StreamSource::StreamSource(FILE* file, Format format, int depth)
+	: m_file(file), m_format(format), m_width(0), m_height(0), m_skipped(0),
+	  m_frames(depth), m_running(true) {}
+
+StreamSource* StreamSource::open(const std::string& filename, Format format, 
+	int width, int height, int depth) {
+
+	FILE* file = (filename == "-") ? stdin : fopen(filename.c_str(), "rb");
+	if (file == NULL) {
+		std::cout << "# [source_error] Cannot open '" << filename << "' !\n";
+		return NULL;
+	}
+
+	StreamSource* source = new StreamSource(file, format, depth);
+	source->m_width = width;
+	source->m_height = height;
+
+	if (format == Y4M && !source->readHeader()) {
+		std::cout << "# [source_error] '" << filename << "' is not a YUV4MPEG2 stream !\n";
+		source->m_running = false;
+		delete source;
+		return NULL;
+	}
+
+	source->m_reader = std::thread(&StreamSource::read, source);
+	return source;
+}
+
+// "YUV4MPEG2 W<width> H<height> ... C<colorspace> ...\n"
+bool StreamSource::readHeader() {
+	char line[256];
+	if (fgets(line, sizeof(line), m_file) == NULL || strncmp(line, "YUV4MPEG2 ", 10) != 0)
+		return false;
+
+	std::string colorspace = "420";
+	for (char* field = strtok(line + 10, " \n"); field != NULL; field = strtok(NULL, " \n")) {
+		if (field[0] == 'W') m_width = atoi(field + 1);
+		if (field[0] == 'H') m_height = atoi(field + 1);
+		if (field[0] == 'C') colorspace = field + 1;
+	}
+	if (m_width <= 0 || m_height <= 0)
+		return false;
+
+	int chroma_width = (m_width + 1) / 2;
+	int chroma_height = (m_height + 1) / 2;
+
+	// 8 bits samples only ("mono16", "420p10", ... are not)
+	if (colorspace == "mono")
+		m_skipped = 0;
+	else if (colorspace == "444alpha")
+		m_skipped = 3 * m_width * m_height;
+	else if (colorspace == "444")
+		m_skipped = 2 * m_width * m_height;
+	else if (colorspace == "422")
+		m_skipped = 2 * chroma_width * m_height;
+	else if (colorspace == "411")
+		m_skipped = 2 * ((m_width + 3) / 4) * m_height;
+	else if (colorspace == "420" || colorspace == "420jpeg" || 
+	         colorspace == "420mpeg2" || colorspace == "420paldv")
+		m_skipped = 2 * chroma_width * chroma_height;
+	else {
+		std::cout << "# [source_error] Unsupported colorspace : C" << colorspace << " !\n";
+		return false;
+	}
+
+	m_scratch.resize(m_skipped);
+	return true;
+}
+
+// false at the end of the stream
+bool StreamSource::readFrame(Frame& frame) {
+	if (m_format == Y4M) {
+		char marker[256];	// "FRAME[ <parameters>]\n"
+		if (fgets(marker, sizeof(marker), m_file) == NULL || strncmp(marker, "FRAME", 5) != 0)
+			return false;
+	}
+
+	frame.realloc(m_width, m_height);
+	if (fread(frame.data(), 1, m_width * m_height, m_file) != m_width * m_height)
+		return false;
+	if (m_skipped > 0 && fread(&m_scratch[0], 1, m_skipped, m_file) != m_skipped)
+		return false;
+	return true;
+}
+
+// Reading thread
+void StreamSource::read() {
+	while (m_running) {
+		Frame frame(0, 0, &m_pool);
+		if (!readFrame(frame))
+			break;
+		m_frames.push(std::move(frame));	// back-pressure
+	}
+	m_frames.close();
+}
+
+// The frame is taken over from the queue, on the same pool
+Frame StreamSource::next() {
+	Frame frame(0, 0, &m_pool);
+	m_frames.pop(frame);
+	return frame;
+}
+
+// The reader is let through the full queue, to its end
+StreamSource::~StreamSource() {
+	m_running = false;
+	if (m_reader.joinable()) {
+		Frame frame(0, 0, &m_pool);
+		while (m_frames.pop(frame)) {}
+		m_reader.join();
+	}
+
+	if (m_file != stdin)
+		fclose(m_file);
+}
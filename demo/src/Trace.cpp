@@ -0,0 +1,117 @@
+#include "../include/Trace.h"
+
+#include <time.h>
+#include <fstream>
+#include <iostream>
+
+std::atomic <bool> Trace::s_enabled(false);
+std::mutex Trace::s_mutex;
+std::vector <Trace::Buffer*> Trace::s_buffers;
+
+uint64_t Trace::now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000ull + time.tv_nsec;
+}
+
+void Trace::enable(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+
+bool Trace::enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+// The buffer of the calling thread, registered on first use
+Trace::Buffer* Trace::buffer() {
+	static thread_local Buffer* t_buffer = NULL;
+
+	if (t_buffer == NULL) {
+		t_buffer = new Buffer();
+		t_buffer->size = 0;
+		t_buffer->dropped = 0;
+
+		std::lock_guard <std::mutex> lock(s_mutex);
+		t_buffer->thread = s_buffers.size() + 1;
+		s_buffers.push_back(t_buffer);
+	}
+	return t_buffer;
+}
+
+void Trace::record(const char* name, int id, uint64_t begin, uint64_t end) {
+	Buffer* buffer = Trace::buffer();
+	int size = buffer->size.load(std::memory_order_relaxed);
+
+	if (size == CAPACITY) {
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// allocated on the first event, so that naming a thread is free
+	if (buffer->events.empty())
+		buffer->events.resize(CAPACITY);
+
+	Event event = {name, id, begin, end};
+	buffer->events[size] = event;
+	buffer->size.store(size + 1, std::memory_order_release);
+}
+
+void Trace::setThreadName(const std::string& name) {
+	Buffer* buffer = Trace::buffer();
+	std::lock_guard <std::mutex> lock(s_mutex);
+	buffer->name = name;
+}
+
+// Complete events ('X'), in us from the first recorded one
+bool Trace::dump(const char* filename) {
+	std::ofstream file(filename);
+	if (!file) {
+		std::cout << "# [trace_error] Cannot write '" << filename << "' !\n";
+		return false;
+	}
+
+	std::lock_guard <std::mutex> lock(s_mutex);
+
+	uint64_t origin = UINT64_MAX;
+	for (int k = 0; k < s_buffers.size(); k++)
+		if (s_buffers[k]->size.load(std::memory_order_acquire) > 0)
+			origin = std::min(origin, s_buffers[k]->events[0].begin);
+
+	file << "{\"traceEvents\":[\n";
+	bool first = true;
+	long dropped = 0;
+
+	for (int k = 0; k < s_buffers.size(); k++) {
+		const Buffer* buffer = s_buffers[k];
+		int size = buffer->size.load(std::memory_order_acquire);
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+		if (!buffer->name.empty()) {
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" 
+			     << buffer->thread << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+			first = false;
+		}
+
+		for (int i = 0; i < size; i++) {
+			const Event& event = buffer->events[i];
+			file << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" 
+			     << buffer->thread << ",\"ts\":" << (event.begin - origin) / 1e3 
+			     << ",\"dur\":" << (event.end - event.begin) / 1e3;
+			if (event.id >= 0)
+				file << ",\"args\":{\"id\":" << event.id << "}";
+			file << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+
+	if (dropped > 0)
+		std::cout << "# [trace_warning] " << dropped << " events dropped (full buffers)\n";
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Span::Span(const char* name, int id)
+	: m_name(name), m_id(id), m_begin(Trace::enabled() ? Trace::now() : 0) {}
+
+Span::~Span() {
+	if (m_begin != 0)
+		Trace::record(m_name, m_id, m_begin, Trace::now());
+}
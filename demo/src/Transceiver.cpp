@@ -1,78 +1,199 @@
 #include "../include/Transceiver.h"
+#include "../include/Trace.h"
 
-Transceiver::Transceiver(const char* id) : m_id(id) {
-	usb_init();
-	usb_find_busses();
-	usb_find_devices();
+const int Transceiver::SLICE;
 
-	m_fx2lp = find_device();
-
-	if (m_fx2lp == NULL) {
-		std::cout << "# [usb_error] Cannot find the FX2-LP device !\n";
-		std::cout << "# You may try to run the program as root ...\n";
-		exit(1);
-	}
-
-	if (usb_claim_interface(m_handle, 0) < 0) {
-		std::cout << "[usb_error] Failed at claiming the interface 0 !\n";
-		exit(1);
-	}
+Transceiver::Transceiver(Link* link) 
+	: m_link(link), m_in_flight(0), m_flight_type(Transfer::CONTROL),
+	  m_n_queued(0), m_n_done(0), m_failed(false), 
+	  m_tx_latency(NULL), m_rx_latency(NULL), m_payload_begin(0) {
 
 	// allocate the internal buffer
 	m_rx_payload = 4096;
 	m_tx_payload = 4096;
 	
-	m_rx_buffer = new char[m_rx_payload];
-	m_tx_buffer = new char[m_tx_payload];
+	m_rx_buffer = alloc(m_rx_payload);
+	m_tx_buffer = alloc(m_tx_payload);
 
 	// reset the FX2-LP device 
 	std::cout << "# Configuring the FX2-LP controller ...\n";
-	usb_control_msg(m_handle, 0x40, 0x83, 0, 0, NULL, 0, 1000);
-}
-
-struct usb_device* Transceiver::find_device() {
-	struct usb_bus *bus_search;
-	struct usb_device *device_search;
-
-	bus_search = usb_busses;
-	while (bus_search != NULL) {
-	    device_search = bus_search->devices;
-	    
-	    while (device_search != NULL) {
-	        if (device_search->descriptor.idVendor == 0x221a && 
-				device_search->descriptor.idProduct == 0x100 ) {
-				
-				char product_id[256];
-	            m_handle = usb_open(device_search);
-	            usb_get_string_simple(m_handle, device_search->descriptor.iProduct, product_id, 256);
-
-	            if (!strncmp(m_id, product_id , 16))
-	                return device_search;
-
-	            usb_close(m_handle);
-	        }
-	        device_search = device_search->next;
-	    }
-	    bus_search = bus_search->next;
+	complete(push(Transfer::CONTROL, CMD_RESET, 0, NULL, 0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Transfer* Transceiver::acquire() {
+	if (m_free.empty())
+		return new Transfer;
+	Transfer* transfer = m_free.back();
+	m_free.pop_back();
+	return transfer;
+}
+
+long Transceiver::push(Transfer::Type type, int request, int value, char* buffer, int length, bool last) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+
+	Transfer* transfer = acquire();
+	transfer->type = type;
+	transfer->request = request;
+	transfer->value = value;
+	transfer->buffer = buffer;
+	transfer->length = length;
+	transfer->last = last;
+	transfer->status = 0;
+	transfer->ticket = ++m_n_queued;
+	transfer->callback = onComplete;
+	transfer->user = this;
+
+	m_pending.push_back(transfer);
+	pump();
+	return transfer->ticket;
+}
+
+long Transceiver::pushBulk(Transfer::Type type, char* buffer, int length) {
+	long ticket = 0;
+	for (int offset = 0; offset < length; offset += SLICE) {
+		int slice = std::min(SLICE, length - offset);
+		ticket = push(type, 0, 0, buffer + offset, slice, offset + slice == length);
 	}
-	return NULL;
+	return ticket;
 }
 
-void Transceiver::tx() {
-	usb_control_msg(m_handle, 0x40, 0x80, 0, 0, NULL, 0, 1000);
-	usb_bulk_write(m_handle, 0x06, m_tx_buffer, m_tx_payload, 250);
+void Transceiver::pump() {
+	while (!m_pending.empty()) {
+		Transfer* transfer = m_pending.front();
+		
+		bool idle = (m_in_flight == 0);
+		bool stream = transfer->type != Transfer::CONTROL && 
+			transfer->type == m_flight_type && m_in_flight < DEPTH;
+
+		if (!idle && !stream)
+			return;
+
+		m_pending.pop_front();
+		m_in_flight++;
+
+		// a payload always follows a vendor command
+		if (transfer->type != Transfer::CONTROL && m_flight_type == Transfer::CONTROL &&
+			(m_tx_latency != NULL || m_rx_latency != NULL))
+			m_payload_begin = Trace::now();
+		m_flight_type = transfer->type;
+
+		if (m_link->submit(transfer) < 0) {
+			std::cout << "# [usb_error] Cannot submit the transfer !\n";
+			m_failed = true;
+			m_in_flight--;
+			m_n_done = transfer->ticket;
+			m_free.push_back(transfer);
+			m_cond.notify_all();
+		}
+	}
 }
 
-void Transceiver::rx() {
-	usb_control_msg(m_handle, 0x40, 0x81, 0, 0, NULL, 0, 1000);
-	usb_bulk_read(m_handle, 0x82, m_rx_buffer, m_rx_payload, 250);
+void Transceiver::onComplete(Transfer* transfer) {
+	Transceiver* self = (Transceiver*) transfer->user;
+	std::lock_guard <std::mutex> lock(self->m_mutex);
+
+	if (transfer->status != 0) {
+		if (!self->m_failed)
+			std::cout << "# [usb_error] Transfer failed (" << transfer->status << ") !\n";
+		self->m_failed = true;
+	}
+
+	if (transfer->type == Transfer::CONTROL && transfer->request == CMD_REQUEST)
+		self->m_request_timer.reset();
+
+	if (transfer->type != Transfer::CONTROL && transfer->last) {
+		Histogram* latency = (transfer->type == Transfer::BULK_OUT) ? 
+			self->m_tx_latency : self->m_rx_latency;
+		if (latency != NULL)
+			latency->record(Trace::now() - self->m_payload_begin);
+	}
+
+	self->m_in_flight--;
+	self->m_n_done = transfer->ticket;
+	self->m_free.push_back(transfer);
+
+	self->pump();
+	self->m_cond.notify_all();
 }
 
-void Transceiver::irq(int request)
-{
-	usb_control_msg(m_handle, 0x40, 0x82, request, 0, NULL, 0, 1000);
+////////////////////////////////////////////////////////////////////////////////
+
+char* Transceiver::alloc(int size) { 
+	char* buffer = m_link->alloc(size);
+	m_owners[buffer] = m_link;
+	return buffer;
+}
+
+void Transceiver::release(char* buffer, int size) { 
+	std::map <char*, Link*>::iterator it = m_owners.find(buffer);
+	if (it == m_owners.end()) return;
+	it->second->release(buffer, size);
+	m_owners.erase(it);
 }
 
+long Transceiver::submitTx(char* buffer, int size) {
+	push(Transfer::CONTROL, CMD_SEND, 0, NULL, 0);
+	return pushBulk(Transfer::BULK_OUT, buffer, size);
+}
+
+long Transceiver::submitRx(char* buffer, int size) {
+	push(Transfer::CONTROL, CMD_RECEIVE, 0, NULL, 0);
+	return pushBulk(Transfer::BULK_IN, buffer, size);
+}
+
+long Transceiver::submitIrq(int request) {
+	return push(Transfer::CONTROL, CMD_REQUEST, request, NULL, 0);
+}
+
+bool Transceiver::done(long ticket) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_n_done >= ticket;
+}
+
+void Transceiver::complete(long ticket) {
+	std::unique_lock <std::mutex> lock(m_mutex);
+	while (m_n_done < ticket)
+		m_cond.wait(lock);
+}
+
+// 'time' is the device processing time of the request (ms)
+void Transceiver::wait(long ticket, double time) {
+	complete(ticket);
+	if (m_link->synchronous())
+		return;
+
+	double elapsed;
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		elapsed = m_request_timer.getMillisec();
+	}
+	if (elapsed < time)
+		m_request_timer.sleep(time - elapsed);
+}
+
+bool Transceiver::failed() { 
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_failed; 
+}
+
+bool Transceiver::synchronous() { return m_link->synchronous(); }
+
+void Transceiver::observe(Histogram* tx, Histogram* rx) {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	m_tx_latency = tx;
+	m_rx_latency = rx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Transceiver::tx() { complete(submitTx(m_tx_buffer, m_tx_payload)); }
+
+void Transceiver::rx() { complete(submitRx(m_rx_buffer, m_rx_payload)); }
+
+void Transceiver::irq(int request) { complete(submitIrq(request)); }
+
 void Transceiver::setData(char* data) { 
 	std::memcpy(m_tx_buffer, data, m_tx_payload); 
 }
@@ -80,15 +201,26 @@ void Transceiver::setData(char* data) {
 char* Transceiver::getData() { return m_rx_buffer; } 
 
 void Transceiver::setRxPayload(int size) {
+	release(m_rx_buffer, m_rx_payload);
 	m_rx_payload = size;
-	delete [] m_rx_buffer;
-	m_rx_buffer = new char[m_rx_payload];
+	m_rx_buffer = alloc(m_rx_payload);
 }
 
 void Transceiver::setTxPayload(int size) {
+	release(m_tx_buffer, m_tx_payload);
 	m_tx_payload = size;
-	delete [] m_tx_buffer;
-	m_tx_buffer = new char[m_tx_payload];
+	m_tx_buffer = alloc(m_tx_payload);
 }
 
-Transceiver::~Transceiver() {}
+Transceiver::~Transceiver() {
+	complete(m_n_queued);
+
+	release(m_rx_buffer, m_rx_payload);
+	release(m_tx_buffer, m_tx_payload);
+	delete m_link;
+
+	while (!m_free.empty()) {
+		delete m_free.back();
+		m_free.pop_back();
+	}
+}
@@ -0,0 +1,150 @@
+#include "../include/UsbLink.h"
+
+UsbLink::UsbLink(const char* id, int index)
+	: m_id(id), m_index(index), m_context(NULL), m_handle(NULL), m_running(true) {
+
+	if (libusb_init(&m_context) < 0) {
+		std::cout << "# [usb_error] Cannot initialize libusb !\n";
+		exit(1);
+	}
+
+	m_handle = find_device(m_context, m_id, m_index);
+
+	if (m_handle == NULL) {
+		std::cout << "# [usb_error] Cannot find the FX2-LP device !\n";
+		std::cout << "# You may try to run the program as root ...\n";
+		exit(1);
+	}
+
+	if (libusb_claim_interface(m_handle, 0) < 0) {
+		std::cout << "[usb_error] Failed at claiming the interface 0 !\n";
+		exit(1);
+	}
+
+	m_events = std::thread(&UsbLink::handle_events, this);
+}
+
+// The 'index'-th device whose product string matches 'id'
+libusb_device_handle* UsbLink::find_device(libusb_context* context, const char* id, int index) {
+	libusb_device** list;
+	libusb_device_handle* found = NULL;
+
+	ssize_t n_devices = libusb_get_device_list(context, &list);
+
+	for (ssize_t i = 0; i < n_devices && found == NULL; i++) {
+		libusb_device_descriptor descriptor;
+		libusb_get_device_descriptor(list[i], &descriptor);
+
+		if (descriptor.idVendor == 0x221a && descriptor.idProduct == 0x100) {
+			libusb_device_handle* handle;
+			if (libusb_open(list[i], &handle) < 0)
+				continue;
+
+			unsigned char product_id[256] = {};
+			libusb_get_string_descriptor_ascii(handle, descriptor.iProduct, product_id, 256);
+
+			if (!strncmp(id, (char*) product_id, 16) && index-- == 0)
+				found = handle;
+			else
+				libusb_close(handle);
+		}
+	}
+
+	libusb_free_device_list(list, 1);
+	return found;
+}
+
+int UsbLink::count(const char* id) {
+	libusb_context* context;
+	if (libusb_init(&context) < 0)
+		return 0;
+
+	int n_boards = 0;
+	libusb_device_handle* handle;
+	while ((handle = find_device(context, id, n_boards)) != NULL) {
+		libusb_close(handle);
+		n_boards++;
+	}
+
+	libusb_exit(context);
+	return n_boards;
+}
+
+void UsbLink::handle_events() {
+	while (m_running) {
+		struct timeval timeout = {0, 100000};
+		libusb_handle_events_timeout_completed(m_context, &timeout, NULL);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int UsbLink::submit(Transfer* transfer) {
+	libusb_transfer* usb_transfer = libusb_alloc_transfer(0);
+
+	if (transfer->type == Transfer::CONTROL) {
+		unsigned char* setup = new unsigned char[LIBUSB_CONTROL_SETUP_SIZE];
+		libusb_fill_control_setup(setup, 0x40, transfer->request, transfer->value, 0, 0);
+		libusb_fill_control_transfer(usb_transfer, m_handle, setup,
+			complete, transfer, 1000);
+	} else {
+		int endpoint = (transfer->type == Transfer::BULK_OUT) ? EP_OUT : EP_IN;
+		libusb_fill_bulk_transfer(usb_transfer, m_handle, endpoint,
+			(unsigned char*) transfer->buffer, transfer->length, 
+			complete, transfer, 250);
+	}
+
+	int error = libusb_submit_transfer(usb_transfer);
+	if (error < 0) {
+		if (transfer->type == Transfer::CONTROL)
+			delete [] usb_transfer->buffer;
+		libusb_free_transfer(usb_transfer);
+	}
+	return error;
+}
+
+void LIBUSB_CALL UsbLink::complete(libusb_transfer* usb_transfer) {
+	Transfer* transfer = (Transfer*) usb_transfer->user_data;
+
+	transfer->status = (usb_transfer->status == LIBUSB_TRANSFER_COMPLETED) ? 
+		0 : -(int) usb_transfer->status;
+
+	if (transfer->type == Transfer::CONTROL)
+		delete [] usb_transfer->buffer;
+	libusb_free_transfer(usb_transfer);
+
+	transfer->callback(transfer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+char* UsbLink::alloc(int size) {
+#if defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000105)
+	char* buffer = (char*) libusb_dev_mem_alloc(m_handle, size);
+	if (buffer != NULL) {
+		m_pinned.insert(buffer);
+		return buffer;
+	}
+#endif
+	return Link::alloc(size);
+}
+
+void UsbLink::release(char* buffer, int size) {
+#if defined(LIBUSB_API_VERSION) && (LIBUSB_API_VERSION >= 0x01000105)
+	if (m_pinned.erase(buffer)) {
+		libusb_dev_mem_free(m_handle, (unsigned char*) buffer, size);
+		return;
+	}
+#endif
+	Link::release(buffer, size);
+}
+
+UsbLink::~UsbLink() {
+	m_running = false;
+	if (m_events.joinable())
+		m_events.join();
+
+	libusb_release_interface(m_handle, 0);
+	libusb_close(m_handle);
+	libusb_exit(m_context);
+}
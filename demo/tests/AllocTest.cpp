@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////
+// Frame buffer allocations per frame, once warmed up
+// ---------------------------------------------------------
+// Runs a few frames of the sequence through the demo's 
+// pipeline (canva, interface on a fake board and detector),
+// and fails unless no frame buffer is allocated anymore 
+// after the first frames. The frames are decoded in place 
+// by the canva, a read-ahead source warming up at its own
+// pace.
+// usage : alloc_test <images directory>
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+
+#include "../include/Frame.h"
+#include "../include/Canva.h"
+#include "../include/Interface.h"
+#include "../include/Detector.h"
+
+static const int WARM_UP	= 3;
+static const int N_FRAMES	= 10;
+
+int main(int argc, char* argv[]) {
+	const int N_OUT		= 3;
+	const char * ARCH	= "c9-p2-c9-p2-c9-p2-c9";
+
+	const int H_SIZE	= 720;
+	const int V_SIZE	= 240;
+
+	std::string folder = (argc > 1) ? argv[1] : "../data/kitti-51/";
+
+	Interface CrayOn(ARCH, "fake:1");
+	CrayOn.setLabelNb(N_OUT);
+
+	Detector detector(H_SIZE, V_SIZE);
+	detector.setStride(8);
+	Canva canva;
+
+	int n_failures = 0;
+	for (int k = 0; k < N_FRAMES; k++) {
+		long allocations = Frame::allocations();
+
+		std::stringstream path;
+		path << folder << std::setfill('0') << std::setw(10) << k << ".png";
+		Frame input = canva.load(path.str());
+		if (input.width() == 0)
+			return 1;
+
+		canva.resizeCrop(input, CrayOn.input(), 0.64, H_SIZE, V_SIZE);
+		CrayOn.push();
+		CrayOn.process();
+
+		for (int i = 1; i < N_OUT; i++)
+			detector.pushHeatMap(CrayOn.pull(i));
+		detector.process();
+
+		long count = Frame::allocations() - allocations;
+		std::cout << "# Frame " << k << " : " << count << " allocation(s)\n";
+		if (k >= WARM_UP && count != 0)
+			n_failures++;
+	}
+
+	if (n_failures > 0) {
+		std::cout << "# [test_error] " << n_failures << " frame(s) still allocating after " 
+		          << WARM_UP << " frames !\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////
+// Software model against a golden tile
+// ---------------------------------------------------------
+// Runs the xz11 network of the demo on the scalar engine,
+// over the tile of 'golden/tile_in.bin' (the second tile of
+// a KITTI frame, as gathered for the board), and fails
+// unless the 15360 bytes read back match the ones of
+// 'golden/tile_xz11.bin', byte for byte.
+// The golden results were produced by the scalar engine
+// itself: they pin its arithmetic down until a capture of
+// the board (or of the VHDL testbench) replaces them.
+// usage : golden_test <golden directory> <coe directory>
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../include/Engine.h"
+#include "../include/Model.h"
+
+static const int IO_SIZE		= 76800;
+static const int RESULT_SIZE	= 15360;
+
+std::vector <unsigned char> readFile(const std::string& filename) {
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	return std::vector <unsigned char> (std::istreambuf_iterator <char> (file),
+		std::istreambuf_iterator <char> ());
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::cout << "# usage : golden_test <golden directory> <coe directory>\n";
+		return 1;
+	}
+	std::string golden = argv[1];
+	std::string coe = argv[2];
+
+	std::vector <unsigned char> tile = readFile(golden + "/tile_in.bin");
+	std::vector <unsigned char> expected = readFile(golden + "/tile_xz11.bin");
+	if (tile.size() != IO_SIZE || expected.size() != RESULT_SIZE) {
+		std::cout << "# [test_error] Cannot read the golden tile in '" << golden << "' !\n";
+		return 1;
+	}
+
+	Model model;
+	model.setProgram(Model::parseCoe((coe + "/p_xz11.coe").c_str()));
+	model.setKernels(Model::parseCoe((coe + "/k_xz11.coe").c_str()));
+
+	// same load requests as 'Interface::load()'
+	Engine engine;
+	engine.setVectorized(false);
+	engine.request(2, (unsigned char*) model.program());
+	int n_chunks = model.kernelsSize() / Model::KERNELS_CHUNK;
+	for (int chunk = 0; chunk < n_chunks; chunk++)
+		engine.request(1 + (chunk << 2), (unsigned char*) model.kernels() + chunk * Model::KERNELS_CHUNK);
+
+	engine.request(0, &tile[0]);
+
+	int n_differences = 0;
+	for (int k = 0; k < RESULT_SIZE; k++)
+		if (tile[k] != expected[k]) {
+			if (n_differences == 0)
+				std::cout << "# [test_error] First difference at byte " << k << " : "
+				          << (int) tile[k] << " instead of " << (int) expected[k] << "\n";
+			n_differences++;
+		}
+
+	if (n_differences > 0) {
+		std::cout << "# [test_error] " << n_differences << " byte(s) differ from the golden tile !\n";
+		return 1;
+	}
+	std::cout << "# The scalar engine matches the golden tile\n";
+	return 0;
+}
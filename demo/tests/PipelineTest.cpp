@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////
+// Results of the tile pipeline, whatever the parallelism
+// ---------------------------------------------------------
+// A few synthetic frames are processed in turn, the first
+// one coming back last: its output maps must not depend on
+// the frame processed before. They must also be the same
+// on one fake board and on several (the tiles being
+// scheduled and stitched out of order), and with the
+// software model on one worker and on several.
+// usage : pipeline_test <coe directory>
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Frame.h"
+#include "../include/Interface.h"
+
+static const int N_OUT		= 3;
+static const int H_SIZE		= 720;
+static const int V_SIZE		= 240;
+
+typedef std::vector <BYTE> Maps;
+
+// A deterministic pattern, different for each seed
+Frame pattern(int seed) {
+	Frame frame(H_SIZE, V_SIZE);
+	for (int y = 0; y < V_SIZE; y++)
+		for (int x = 0; x < H_SIZE; x++)
+			frame(x, y) = (BYTE) ((x * 3 + y * 5 + seed * 29) ^ ((x * y) >> 4));
+	return frame;
+}
+
+// The output maps of the frames A, B, then A again. The fake
+// boards loop the tiles back, so they need no model.
+std::vector <Maps> run(const char* backend, const std::string& coe, bool model) {
+	const char * ARCH	= "c9-p2-c9-p2-c9-p2-c9";
+	const int seeds[3]	= { 0, 1, 0 };
+
+	Interface CrayOn(ARCH, backend);
+	CrayOn.setLabelNb(N_OUT);
+	if (model) {
+		CrayOn.load((coe + "p_xz11.coe").c_str(), 'p');
+		CrayOn.load((coe + "k_xz11.coe").c_str(), 'k');
+	}
+
+	std::vector <Maps> outputs;
+	for (int k = 0; k < 3; k++) {
+		Frame input = pattern(seeds[k]);
+		CrayOn.push(input);
+		CrayOn.process();
+
+		Maps maps;
+		for (int i = 0; i < N_OUT; i++) {
+			Frame& output = CrayOn.pull(i);
+			maps.insert(maps.end(), output.data(), output.data() + output.width() * output.height());
+		}
+		outputs.push_back(maps);
+	}
+	return outputs;
+}
+
+bool stateless(const char* backend, const std::string& coe, bool model) {
+	std::vector <Maps> outputs = run(backend, coe, model);
+
+	if (outputs[0].empty() || outputs[0] == outputs[1] || outputs[2] != outputs[0]) {
+		std::cout << "# [test_error] '" << backend << "' does not give a frame its own maps !\n";
+		return false;
+	}
+	std::cout << "# '" << backend << "' gives a frame its own maps\n";
+	return true;
+}
+
+bool same(const char* reference, const char* backend, const std::string& coe, bool model) {
+	std::vector <Maps> expected = run(reference, coe, model);
+	std::vector <Maps> result = run(backend, coe, model);
+
+	if (expected[0].empty() || result != expected) {
+		std::cout << "# [test_error] '" << backend << "' differs from '" << reference << "' !\n";
+		return false;
+	}
+	std::cout << "# '" << backend << "' matches '" << reference << "'\n";
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	std::string coe = (argc > 1) ? argv[1] : "../coe/";
+	if (coe[coe.size() - 1] != '/')
+		coe += '/';
+
+	bool passed = stateless("fake", coe, false);
+	passed &= same("fake:1", "fake:3", coe, false);
+	passed &= stateless("cpu:1", coe, true);
+	passed &= same("cpu:1", "cpu:3", coe, true);
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////
+// Transfer engine against an in-process board
+// ---------------------------------------------------------
+// Drives a Transceiver over a fake board, through a link
+// which logs the transfers and can hold them back, and
+// checks the vendor commands (0x80 - 0x83) of each exchange,
+// the slicing of the bulk payloads and the slices kept in
+// flight, the commands acting as barriers, and the loopback
+// of the i/o buffer. The fake board must also stall a
+// vendor command coming after a partial payload.
+// usage : transceiver_test
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "../include/Transceiver.h"
+#include "../include/FakeLink.h"
+
+static const int IO_SIZE		= 76800;
+static const int RESULT_SIZE	= 15360;
+static const int SLICE			= 16384;
+static const int DEPTH			= 4;
+
+// Logs the transfers going to a fake board. Once 'hold()'
+// has been called, they are kept back until 'pass()'.
+class HeldLink : public Link {
+ private :
+	FakeLink* m_board;
+	std::vector <Transfer> m_log;
+	std::deque <Transfer*> m_held;
+	bool m_holding;
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+
+ public :
+	HeldLink(FakeLink* board) : m_board(board), m_holding(false) {}
+
+	int submit(Transfer* transfer) {
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_log.push_back(*transfer);
+		m_cond.notify_all();
+		if (!m_holding)
+			return m_board->submit(transfer);
+		m_held.push_back(transfer);
+		return 0;
+	}
+
+	void hold() {
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_holding = true;
+	}
+
+	// lets 'n' held transfers go (all of them if n < 0)
+	void pass(int n = -1) {
+		std::lock_guard <std::mutex> lock(m_mutex);
+		if (n < 0)
+			m_holding = false;
+		while (!m_held.empty() && n-- != 0) {
+			m_board->submit(m_held.front());
+			m_held.pop_front();
+		}
+	}
+
+	// the log once 'n' transfers went through, or after a timeout
+	std::vector <Transfer> log(size_t n) {
+		std::unique_lock <std::mutex> lock(m_mutex);
+		m_cond.wait_for(lock, std::chrono::seconds(1), [&] { return m_log.size() >= n; });
+		lock.unlock();
+
+		// and nothing more comes after a while
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		lock.lock();
+		return m_log;
+	}
+
+	~HeldLink() { delete m_board; }
+};
+
+int n_failures = 0;
+
+void check(bool condition, const char* what) {
+	if (!condition) {
+		std::cout << "# [test_error] " << what << " !\n";
+		n_failures++;
+	}
+}
+
+bool isCommand(const Transfer& transfer, int request) {
+	return transfer.type == Transfer::CONTROL && transfer.request == request;
+}
+
+bool isSlice(const Transfer& transfer, Transfer::Type type, char* buffer, int length) {
+	return transfer.type == type && transfer.buffer == buffer && transfer.length == length;
+}
+
+// The vendor protocol and the slicing of the payloads
+void testExchanges() {
+	FakeLink* board = new FakeLink();
+	HeldLink* link = new HeldLink(board);
+	Transceiver transceiver(link);
+
+	std::vector <Transfer> log = link->log(1);
+	check(log.size() == 1 && isCommand(log[0], CMD_RESET), "The board is not reset first");
+
+	char* output = transceiver.alloc(IO_SIZE);
+	char* input = transceiver.alloc(RESULT_SIZE);
+	for (int k = 0; k < IO_SIZE; k++)
+		output[k] = (char) (k * 7 + k / 256);
+
+	// the slices wait for the vendor command
+	link->hold();
+	long tx = transceiver.submitTx(output, IO_SIZE);
+	log = link->log(2);
+	check(log.size() == 2 && isCommand(log[1], CMD_SEND), "The upload does not start with 0x80 alone");
+
+	// then DEPTH of them are kept in flight
+	link->pass(1);
+	log = link->log(2 + DEPTH);
+	bool sliced = (log.size() == 2 + DEPTH);
+	for (int k = 0; sliced && k < DEPTH; k++)
+		sliced = isSlice(log[2 + k], Transfer::BULK_OUT, output + k * SLICE, SLICE);
+	check(sliced, "The upload is not sent as slices in flight");
+
+	// the interrupt request waits behind the payload
+	long irq = transceiver.submitIrq(3);
+	log = link->log(2 + DEPTH);
+	check(log.size() == 2 + DEPTH, "The interrupt request overtakes the upload");
+
+	// the last slice takes the place of the first one served
+	link->pass(1);
+	log = link->log(3 + DEPTH);
+	check(log.size() == 3 + DEPTH &&
+		isSlice(log[2 + DEPTH], Transfer::BULK_OUT, output + DEPTH * SLICE, IO_SIZE - DEPTH * SLICE),
+		"The last slice of the upload is not sent");
+
+	link->pass();
+	transceiver.complete(irq);
+	log = link->log(4 + DEPTH);
+	check(transceiver.done(tx), "The upload is not over before the interrupt request");
+	check(log.size() == 4 + DEPTH && isCommand(log[3 + DEPTH], CMD_REQUEST) && log[3 + DEPTH].value == 3,
+		"The interrupt request is not 0x82");
+	check(board->requestCount() == 1, "The board does not count the interrupt request");
+
+	// the results are read back from the i/o buffer
+	transceiver.complete(transceiver.submitRx(input, RESULT_SIZE));
+	log = link->log(6 + DEPTH);
+	check(log.size() == 6 + DEPTH && isCommand(log[4 + DEPTH], CMD_RECEIVE) &&
+		isSlice(log[5 + DEPTH], Transfer::BULK_IN, input, RESULT_SIZE), "The read-back is not 0x81 and one slice");
+	check(std::memcmp(input, output, RESULT_SIZE) == 0, "The board does not loop the payload back");
+	check(!transceiver.failed(), "A transfer failed");
+
+	transceiver.release(input, RESULT_SIZE);
+	transceiver.release(output, IO_SIZE);
+}
+
+int n_served = 0;
+std::mutex served_mutex;
+std::condition_variable served_cond;
+
+void onServed(Transfer* transfer) {
+	std::lock_guard <std::mutex> lock(served_mutex);
+	n_served++;
+	served_cond.notify_all();
+}
+
+// A vendor command after a partial payload is stalled, until a reset
+void testStall() {
+	const int N_TRANSFERS = 5;
+	const int requests[N_TRANSFERS] = { CMD_SEND, 0, CMD_REQUEST, CMD_RESET, CMD_REQUEST };
+	const int expected[N_TRANSFERS] = { 0, 0, -1, 0, 0 };
+
+	std::vector <char> payload(1000, 1);
+	Transfer transfers[N_TRANSFERS];
+	FakeLink board;
+	for (int k = 0; k < N_TRANSFERS; k++) {
+		Transfer& transfer = transfers[k];
+		std::memset(&transfer, 0, sizeof(Transfer));
+		transfer.type = (requests[k] == 0) ? Transfer::BULK_OUT : Transfer::CONTROL;
+		transfer.request = requests[k];
+		transfer.buffer = (requests[k] == 0) ? &payload[0] : NULL;
+		transfer.length = (requests[k] == 0) ? payload.size() : 0;
+		transfer.callback = onServed;
+		board.submit(&transfer);
+	}
+	{
+		std::unique_lock <std::mutex> lock(served_mutex);
+		served_cond.wait_for(lock, std::chrono::seconds(1), [] { return n_served == N_TRANSFERS; });
+	}
+	bool stalled = (n_served == N_TRANSFERS);
+	for (int k = 0; stalled && k < N_TRANSFERS; k++)
+		stalled = (transfers[k].status == expected[k]);
+	check(stalled, "A vendor command after a partial payload is not stalled");
+	check(board.requestCount() == 1, "The stalled interrupt request reached the board");
+
+	// which makes the exchange fail
+	Transceiver transceiver(new FakeLink());
+	transceiver.submitTx(&payload[0], payload.size());
+	transceiver.complete(transceiver.submitIrq(0));
+	check(transceiver.failed(), "The stall is not reported by the transceiver");
+}
+
+int main(int argc, char* argv[]) {
+	testExchanges();
+	testStall();
+
+	if (n_failures > 0)
+		return 1;
+	std::cout << "# The transfers match the protocol of the board\n";
+	return 0;
+}
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////
+// Converts a pair of .coe files (micro-program, kernels)
+// into a binary CrayOn model, to be loaded with mode 'm'.
+// usage : coe2bin p_<net>.coe k_<net>.coe <net>.bin
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include "../include/Model.h"
+
+int main(int argc, char* argv[]) {
+	if (argc != 4) {
+		std::cout << "usage : " << argv[0] << " program.coe kernels.coe model.bin\n";
+		return 1;
+	}
+
+	Model model;
+	model.setProgram(Model::parseCoe(argv[1]));
+	model.setKernels(Model::parseCoe(argv[2]));
+	model.save(argv[3]);
+
+	// read it back, which checks the checksums
+	Model check;
+	check.open(argv[3]);
+
+	std::cout << "# " << argv[3] << " : "
+	          << check.programWords().size() << " program words, "
+	          << check.kernelsSize() / Model::KERNELS_CHUNK << " kernel chunk(s)\n";
+	return 0;
+}